@@ -0,0 +1,91 @@
+//
+//  aligned_memory.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_aligned_memory_hpp
+#define pthread_aligned_memory_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "pthread/exceptions.hpp"
+
+namespace pthread {
+
+    namespace util {
+
+        /** \addtogroup util
+         *
+         * @{
+         */
+
+        /** Allocate count value-initialized T, aligned on alignof(T).
+         *
+         * Before C++17, new T[count] ignores alignments that are greater than alignof(std::max_align_t): cache line
+         * padded types (alignas(64)) must be allocated with this function to really sit on their own cache line.
+         *
+         * If a constructor throws, the items already constructed are destroyed and the memory is freed.
+         *
+         * @param count number of items.
+         * @return the items, release them with aligned_delete().
+         * @throw pthread_exception if the memory could not be allocated or count * sizeof(T) overflows (ENOMEM).
+         */
+        template<class T>
+        T *aligned_new(std::size_t count = 1) {
+            if (count > SIZE_MAX / sizeof(T)) {
+                throw_exception(pthread_exception("failed to allocate aligned memory, too many items.", ENOMEM));
+            }
+
+            void *memory = nullptr;
+            const std::size_t alignment = alignof(T) < sizeof(void *) ? sizeof(void *) : alignof(T);
+            int rc = posix_memalign(&memory, alignment, count * sizeof(T));
+            if (rc != 0) {
+                throw_exception(pthread_exception("failed to allocate aligned memory.", rc));
+            }
+
+            T *items = static_cast<T *>(memory);
+            std::size_t constructed = 0;
+            CPP_PTHREAD_TRY {
+                for (; constructed < count; constructed++) {
+                    new(items + constructed) T();
+                }
+            } CPP_PTHREAD_CATCH_ALL {
+                while (constructed > 0) {
+                    items[--constructed].~T();
+                }
+                std::free(memory);
+                CPP_PTHREAD_RETHROW;
+            }
+
+            return items;
+        }
+
+        /** destroy and free items allocated with aligned_new().
+         *
+         * @param items items to release (nothing is done if nullptr).
+         * @param count number of items, as passed to aligned_new().
+         */
+        template<class T>
+        void aligned_delete(T *items, std::size_t count = 1) noexcept {
+            if (items != nullptr) {
+                for (std::size_t index = count; index > 0; index--) {
+                    items[index - 1].~T();
+                }
+                std::free(items);
+            }
+        }
+
+        /** @} */
+    } // namespace util
+
+} // namespace pthread
+
+#endif /* pthread_aligned_memory_hpp */
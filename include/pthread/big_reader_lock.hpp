@@ -0,0 +1,165 @@
+//
+//  big_reader_lock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_big_reader_lock_hpp
+#define pthread_big_reader_lock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <cstddef>
+
+#include "pthread/mutex.hpp"
+#include "pthread/read_indicator.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Big reader read lock (see big_reader_lock).
+     *
+     * This class cannot be instantiated, create a big_reader_lock and pass it to a lock_guard<big_reader_read_lock> to
+     * get a read lock.
+     */
+    class big_reader_read_lock {
+    public:
+
+        /** apply a read lock, the calling thread only writes to its own reader slot (unless a writer holds the lock).
+         *
+         * Read locks are not recursive: like rwlock_policy::prefer_writers, a waiting writer blocks new readers, a thread
+         * that takes a read lock it already holds while a writer is waiting deadlocks.
+         *
+         * @throw mutex_exception if a writer holds the lock and waiting for it failed.
+         */
+        void lock() {
+            detail::read_indicator::slot &local = _readers.local_slot();
+            local.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (_writer.load(std::memory_order_seq_cst)) {
+                lock_slow(local);
+            }
+        }
+
+        /** @return true if the read lock was acquired, false if a writer holds the lock.
+         */
+        bool try_lock() noexcept {
+            detail::read_indicator::slot &local = _readers.local_slot();
+            local.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (_writer.load(std::memory_order_seq_cst)) {
+                local.readers.fetch_sub(1, std::memory_order_release);
+                return false;
+            }
+            return true;
+        }
+
+        /** release the read lock.
+         */
+        void unlock() noexcept {
+            _readers.depart();
+        }
+
+        /** @return number of reader slots (the number of CPUs rounded up to a power of 2). */
+        std::size_t slots() const noexcept {
+            return _readers.slots();
+        }
+
+        /** not copy-assignable */
+        big_reader_read_lock(const big_reader_read_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const big_reader_read_lock &) = delete;
+
+    protected:
+
+        /** create an unlocked lock, with one reader slot per CPU.
+         *
+         * @throw mutex_exception if the writers' mutex can't be initialized.
+         */
+        big_reader_read_lock();
+
+        /** release resources (not virtual, a big_reader_lock can't be deleted through a pointer to its read lock). */
+        ~big_reader_read_lock();
+
+        /** a writer holds the lock, wait for it to release the lock and then register as a reader.
+         *
+         * @param local slot of the calling thread.
+         */
+        void lock_slow(detail::read_indicator::slot &local);
+
+        detail::read_indicator _readers; //!< one reader counter per CPU
+        std::atomic<bool> _writer;     //!< a writer holds (or is acquiring) the lock
+        pthread::mutex _writers;       //!< serializes writers, readers wait on it when a writer holds the lock
+    };
+
+    /** Big reader write lock (see big_reader_lock).
+     */
+    class big_reader_write_lock : public big_reader_read_lock {
+    public:
+
+        /** apply a write lock: block new readers, then wait for the current readers to leave (all slots are scanned).
+         *
+         * @throw mutex_exception if the writers' mutex can't be locked.
+         */
+        void lock();
+
+        /** @return true if the write lock was acquired, false if the lock is held by a writer or by readers.
+         */
+        bool try_lock() noexcept;
+
+        /** release the write lock, readers waiting for the writer get the lock.
+         *
+         * @throw mutex_exception if the writers' mutex can't be unlocked.
+         */
+        void unlock();
+
+        /** create an unlocked lock, with one reader slot per CPU.
+         *
+         * @throw mutex_exception if the writers' mutex can't be initialized.
+         */
+        big_reader_write_lock() = default;
+
+        /** not copy-assignable */
+        big_reader_write_lock(const big_reader_write_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const big_reader_write_lock &) = delete;
+    };
+
+    /** A read/write lock for read mostly data.
+     *
+     * Each reader increments a counter that lives on its own cache line (threads are spread over one slot per CPU), so
+     * readers running on different CPUs don't bounce a shared cache line. The price is paid by writers: a writer takes a
+     * mutex, blocks new readers and then scans every slot until all the readers are gone. Readers that find a writer
+     * wait on its mutex.
+     *
+     * This lock is meant for data that is read very often and seldom changed (configuration, routing tables, ...). A reader
+     * must release the lock from the thread that acquired it, and must not take a read lock it already holds (writers are
+     * preferred, see lock()). It's used like read_write_lock.
+     *
+     * <pre><code>
+     * pthread::big_reader_lock rwlock;
+     *
+     * {
+     *   pthread::lock_guard<pthread::big_reader_read_lock> lock(rwlock);
+     *   ...
+     * }
+     *
+     * {
+     *   pthread::lock_guard<pthread::big_reader_write_lock> lock(rwlock);
+     *   ...
+     * }
+     * </code></pre>
+     */
+    typedef big_reader_write_lock big_reader_lock;
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_big_reader_lock_hpp */
@@ -11,11 +11,12 @@
 #include <pthread.h>
 #include <string>
 #include <ctime>
-#include <sys/time.h>
+#include <chrono>
 
 #include "pthread/exceptions.hpp"
 #include "pthread/mutex.hpp"
 #include "pthread/lock_guard.hpp"
+#include "pthread/unique_lock.hpp"
 
 namespace pthread {
 
@@ -68,6 +69,14 @@ namespace pthread {
          */
         void wait(mutex &mtx);
 
+        /** Wait for condition to be signaled, errors are reported in ec instead of being thrown.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param ec error returned by pthread_cond_wait, cleared on success.
+         * @see wait(mutex &)
+         */
+        void wait(mutex &mtx, std::error_code &ec) noexcept;
+
         /**  Wait for condition to be signaled within given time frame.
          *
          * The method uses the lock_guard's mutex to execute.
@@ -123,19 +132,31 @@ namespace pthread {
          *
          * Upon successful return, the mutex has been locked and is owned by the calling thread.
          *
-         * If this method is called with millis < 0 then the timeout time is not recalculated. This make it possible to handle spurious
-         * unblocking of condition variable without the need of a lambda expression. The call sequence is then: while(! check_condition() && wait_for(lck, 200) == no_tiemout );
+         * The deadline is computed on each call with the monotonic clock (changing the system time doesn't change the time waited).
+         *
+         * A negative millis times out at once. To handle spurious unblocking without a lambda expression, compute the deadline
+         * once and call wait_until: while(! check_condition() && wait_until(mtx, deadline) == no_timeout );
          *
          * @param mtx ralated mutex, which must be locked by the current thread.
          * @param millis milliseconds to wait for this instance to signaled.
          * @return cv_status (either timeout or no_timeout)
-         * @throw condition_variable_exception is thrown either if timeout calculation failed or mutex ownership was wrong.
+         * @throw condition_variable_exception is thrown if mutex ownership was wrong.
          * @see notify_one
          * @see notify_all
          * @see pthread_cond_timedwait
          */
         cv_status wait_for(mutex &mtx, int millis);
 
+        /** Wait for condition to be signaled within given time frame, errors are reported in ec instead of being thrown.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param millis milliseconds to wait for this instance to signaled.
+         * @param ec error returned by pthread_cond_timedwait (ETIMEDOUT is not an error), cleared on success.
+         * @return cv_status (either timeout or no_timeout)
+         * @see wait_for(mutex &, int)
+         */
+        cv_status wait_for(mutex &mtx, int millis, std::error_code &ec) noexcept;
+
         /** Wait for condition to be signaled within given time frame.
          *
          * The method uses the lock_guard's mutex to execute.
@@ -186,6 +207,242 @@ namespace pthread {
         template<class Lambda>
         bool wait_for(lock_guard<pthread::mutex> &lck, int millis, Lambda lambda);
 
+        /** Wait for condition to be signaled until a deadline is reached.
+         *
+         * This method atomically release mutex and cause the calling thread to block, like wait_for. Waiting again after a spurious
+         * wakeup with the same deadline doesn't extend the time waited.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param deadline when to stop waiting.
+         * @return cv_status (timedout if deadline was reached)
+         * @throw condition_variable_exception if mutex ownership was wrong.
+         * @see pthread_cond_timedwait
+         */
+        cv_status wait_until(mutex &mtx, std::chrono::steady_clock::time_point deadline);
+
+        /** Wait for condition to be signaled until a deadline is reached, errors are reported in ec instead of being thrown.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param deadline when to stop waiting.
+         * @param ec error returned by pthread_cond_timedwait (ETIMEDOUT is not an error), cleared on success.
+         * @return cv_status (timedout if deadline was reached)
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point)
+         */
+        cv_status wait_until(mutex &mtx, std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept;
+
+        /** Wait for condition to be signaled until a deadline is reached.
+         *
+         * The method uses the lock_guard's mutex to execute.
+         *
+         * @param lck ralated mutex lock_guard, which must be locked by the current thread.
+         * @param deadline when to stop waiting (any clock, converted to the steady clock).
+         * @return cv_status (timedout if deadline was reached)
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point)
+         */
+        template<class Clock, class Duration>
+        cv_status wait_until(lock_guard<pthread::mutex> &lck, const std::chrono::time_point<Clock, Duration> &deadline) {
+            return wait_until(*(lck._mutex), detail::steady_deadline(deadline));
+        }
+
+        /** Wait for lambda to return true, or for deadline to be reached.
+         *
+         * The lambda (closure) is run to check if the condition was met. Lambda should return false if the waiting should be continued.
+         * It's run once more when the deadline is reached.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param deadline when to stop waiting (any clock, converted once to the steady clock).
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return the value returned by the last call to lambda.
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point)
+         */
+        template<class Clock, class Duration, class Lambda>
+        bool wait_until(mutex &mtx, const std::chrono::time_point<Clock, Duration> &deadline, Lambda lambda);
+
+        /** Wait for lambda to return true, or for deadline to be reached.
+         *
+         * The method uses the lock_guard's mutex to execute.
+         *
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point, Lambda)
+         */
+        template<class Clock, class Duration, class Lambda>
+        bool wait_until(lock_guard<pthread::mutex> &lck, const std::chrono::time_point<Clock, Duration> &deadline, Lambda lambda) {
+            return wait_until(*(lck._mutex), deadline, lambda);
+        }
+
+        /** Wait for condition to be signaled until a deadline of any clock is reached.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param deadline when to stop waiting, converted to the steady clock.
+         * @return cv_status (timedout if deadline was reached)
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point)
+         */
+        template<class Clock, class Duration>
+        cv_status wait_until(mutex &mtx, const std::chrono::time_point<Clock, Duration> &deadline) {
+            return wait_until(mtx, detail::steady_deadline(deadline));
+        }
+
+        /** Wait for condition to be signaled until a deadline of any clock is reached, errors are reported in ec instead of being thrown.
+         *
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point, std::error_code &)
+         */
+        template<class Clock, class Duration>
+        cv_status wait_until(mutex &mtx, const std::chrono::time_point<Clock, Duration> &deadline, std::error_code &ec) noexcept {
+            return wait_until(mtx, detail::steady_deadline(deadline), ec);
+        }
+
+        /** Wait for condition to be signaled within given time frame (nanosecond resolution, i.e. std::chrono::microseconds(200)).
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param duration time to wait for this instance to be signaled.
+         * @return cv_status (either timeout or no_timeout)
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point)
+         */
+        template<class Rep, class Period>
+        cv_status wait_for(mutex &mtx, const std::chrono::duration<Rep, Period> &duration) {
+            return wait_until(mtx, detail::steady_deadline(duration));
+        }
+
+        /** Wait for condition to be signaled within given time frame, errors are reported in ec instead of being thrown.
+         *
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point, std::error_code &)
+         */
+        template<class Rep, class Period>
+        cv_status wait_for(mutex &mtx, const std::chrono::duration<Rep, Period> &duration, std::error_code &ec) noexcept {
+            return wait_until(mtx, detail::steady_deadline(duration), ec);
+        }
+
+        /** Wait for condition to be signaled within given time frame.
+         *
+         * The method uses the lock_guard's mutex to execute.
+         *
+         * @see wait_for(mutex &, const std::chrono::duration<Rep, Period> &)
+         */
+        template<class Rep, class Period>
+        cv_status wait_for(lock_guard<pthread::mutex> &lck, const std::chrono::duration<Rep, Period> &duration) {
+            return wait_until(*(lck._mutex), detail::steady_deadline(duration));
+        }
+
+        /** Wait, at most for the given duration, for lambda to return true.
+         *
+         * The deadline is computed once, spurious wakeups don't extend the wait.
+         *
+         * @param mtx ralated mutex, which must be locked by the current thread.
+         * @param duration time to wait.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return the value returned by the last call to lambda.
+         * @see wait_until(mutex &, const std::chrono::time_point<Clock, Duration> &, Lambda)
+         */
+        template<class Rep, class Period, class Lambda>
+        bool wait_for(mutex &mtx, const std::chrono::duration<Rep, Period> &duration, Lambda lambda) {
+            return wait_until(mtx, detail::steady_deadline(duration), lambda);
+        }
+
+        /** Wait, at most for the given duration, for lambda to return true.
+         *
+         * The method uses the lock_guard's mutex to execute.
+         *
+         * @see wait_for(mutex &, const std::chrono::duration<Rep, Period> &, Lambda)
+         */
+        template<class Rep, class Period, class Lambda>
+        bool wait_for(lock_guard<pthread::mutex> &lck, const std::chrono::duration<Rep, Period> &duration, Lambda lambda) {
+            return wait_until(*(lck._mutex), detail::steady_deadline(duration), lambda);
+        }
+
+        /** Wait for condition to be signaled.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @see wait(mutex &)
+         */
+        void wait(unique_lock<pthread::mutex> &lck) {
+            wait(*lck.mutex());
+        }
+
+        /** Wait for lambda to return true.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return true
+         * @see wait(mutex &, Lambda)
+         */
+        template<class Lambda>
+        bool wait(unique_lock<pthread::mutex> &lck, Lambda lambda) {
+            return wait(*lck.mutex(), lambda);
+        }
+
+        /** Wait for condition to be signaled within given time frame.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param millis milliseconds to wait for this instance to signaled.
+         * @return cv_status (either timeout or no_timeout)
+         * @see wait_for(mutex &, int)
+         */
+        cv_status wait_for(unique_lock<pthread::mutex> &lck, int millis) {
+            return wait_for(*lck.mutex(), millis);
+        }
+
+        /** Wait, at most millis milliseconds, for lambda to return true.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param millis milliseconds to wait.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return the value returned by the last call to lambda.
+         * @see wait_for(mutex &, int, Lambda)
+         */
+        template<class Lambda>
+        bool wait_for(unique_lock<pthread::mutex> &lck, int millis, Lambda lambda) {
+            return wait_for(*lck.mutex(), millis, lambda);
+        }
+
+        /** Wait for condition to be signaled until a deadline is reached.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param deadline when to stop waiting.
+         * @return cv_status (timedout if deadline was reached)
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point)
+         */
+        template<class Clock, class Duration>
+        cv_status wait_until(unique_lock<pthread::mutex> &lck, const std::chrono::time_point<Clock, Duration> &deadline) {
+            return wait_until(*lck.mutex(), detail::steady_deadline(deadline));
+        }
+
+        /** Wait for lambda to return true, or for deadline to be reached.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param deadline when to stop waiting.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return the value returned by the last call to lambda.
+         * @see wait_until(mutex &, std::chrono::steady_clock::time_point, Lambda)
+         */
+        template<class Clock, class Duration, class Lambda>
+        bool wait_until(unique_lock<pthread::mutex> &lck, const std::chrono::time_point<Clock, Duration> &deadline, Lambda lambda) {
+            return wait_until(*lck.mutex(), deadline, lambda);
+        }
+
+        /** Wait for condition to be signaled within given time frame.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param duration time to wait for this instance to be signaled.
+         * @return cv_status (either timeout or no_timeout)
+         * @see wait_for(mutex &, const std::chrono::duration<Rep, Period> &)
+         */
+        template<class Rep, class Period>
+        cv_status wait_for(unique_lock<pthread::mutex> &lck, const std::chrono::duration<Rep, Period> &duration) {
+            return wait_until(*lck.mutex(), detail::steady_deadline(duration));
+        }
+
+        /** Wait, at most for the given duration, for lambda to return true.
+         *
+         * @param lck unique_lock that owns the related mutex.
+         * @param duration time to wait.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return the value returned by the last call to lambda.
+         * @see wait_for(mutex &, const std::chrono::duration<Rep, Period> &, Lambda)
+         */
+        template<class Rep, class Period, class Lambda>
+        bool wait_for(unique_lock<pthread::mutex> &lck, const std::chrono::duration<Rep, Period> &duration, Lambda lambda) {
+            return wait_until(*lck.mutex(), detail::steady_deadline(duration), lambda);
+        }
+
         /** signal a condition.
          *
          * unblocks at least one of the threads that are blocked on the specified condition variable cond (if any threads are blocked on cond).
@@ -197,6 +454,12 @@ namespace pthread {
          */
         void notify_one() ;
 
+        /** signal a condition, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_cond_signal, cleared on success.
+         */
+        void notify_one(std::error_code &ec) noexcept;
+
         /** broadcast a condition.
          *
          * unblocks all threads currently blocked on the specified condition variable cond.
@@ -209,6 +472,12 @@ namespace pthread {
          */
         void notify_all();
 
+        /** broadcast a condition, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_cond_broadcast, cleared on success.
+         */
+        void notify_all(std::error_code &ec) noexcept;
+
         /**
          * not copy-assignable
          */
@@ -217,6 +486,8 @@ namespace pthread {
         // constructor/destructor ------------------------------------------------
 
         /** construct a new condition_variable.
+         *
+         * Timed waits use CLOCK_MONOTONIC when the platform supports it (pthread_condattr_setclock).
          *
          * @see pthread_cond_init
          */
@@ -236,9 +507,13 @@ namespace pthread {
 
     private:
 
-        void milliseconds(int milliseconds);
+        /** wait until deadline, deadline is converted into a timeout on the condition's clock.
+         *
+         * @return the value returned by pthread_cond_timedwait.
+         */
+        int timed_wait(mutex &mtx, std::chrono::steady_clock::time_point deadline) noexcept;
 
-        timespec timeout;
+        clockid_t _clock;          //!< clock used by pthread_cond_timedwait (CLOCK_MONOTONIC or CLOCK_REALTIME)
         pthread_cond_t _condition; //!< NOSONAR this union is declared in the POSIX Threading library. It cannot be changed (ignoring rule MISRA C++:2008, 9-5-1 - Unions shall not be used.)
     };
 
@@ -268,42 +543,26 @@ namespace pthread {
 
     template<class Lambda>
     bool condition_variable::wait_for(mutex &mtx, int millis, Lambda lambda) {
-        int rc = 0;
-        cv_status status = no_timeout;
-
-        milliseconds(millis); // update timeout
-        bool stop_waiting = lambda(); // returns ​false if the waiting should be continued.
 
-        while ((!stop_waiting) && (status == no_timeout)) {
-
-            rc = pthread_cond_timedwait(&_condition, &mtx._mutex, &timeout);
+        return wait_for(mtx, std::chrono::milliseconds(millis), lambda);
+    };
 
-            switch (rc) {
+    template<class Clock, class Duration, class Lambda>
+    bool condition_variable::wait_until(mutex &mtx, const std::chrono::time_point<Clock, Duration> &deadline, Lambda lambda) {
 
-                case ETIMEDOUT:
-                    status = timedout;
-                    break;
+        const std::chrono::steady_clock::time_point steady_deadline = detail::steady_deadline(deadline); // computed once, spurious wakeups don't extend the wait.
+        bool stop_waiting = lambda(); // returns false if the waiting should be continued.
 
-                case EINVAL:
-                    throw condition_variable_exception("The value specified by abstime is invalid.",
-                                                       rc); // NOSONAR we use throw instead of return.
-                    break;
+        while (!stop_waiting) {
+            cv_status status = wait_until(mtx, steady_deadline);
+            stop_waiting = lambda();
 
-                case EPERM:
-                    throw condition_variable_exception(
-                            "The mutex was not owned by the current thread at the time of the call.",
-                            rc); // NOSONAR we use throw instead of return.
-                    break;
-                default:
-                    status = no_timeout;
-                    break;
+            if (status == timedout) {
+                break;
             }
-
-            stop_waiting = lambda();
         }
 
-
-        return stop_waiting; //status == cv_status::no_timeout;
+        return stop_waiting;
     };
 
     template<class Lambda>
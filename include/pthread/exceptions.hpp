@@ -15,6 +15,21 @@
 #include <string>    // std::string
 #include <cstring>
 #include <exception> // std::exception
+#include <system_error>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+/** defined when the code is compiled with exceptions enabled (not -fno-exceptions). */
+#define CPP_PTHREAD_EXCEPTIONS 1
+#define CPP_PTHREAD_TRY try                  //!< try block that compiles without exceptions
+#define CPP_PTHREAD_CATCH_ALL catch (...)    //!< catch (...) block that compiles (and is never run) without exceptions
+#define CPP_PTHREAD_RETHROW throw            //!< rethrow the current exception (no-op without exceptions)
+#else
+#define CPP_PTHREAD_TRY if (true)
+#define CPP_PTHREAD_CATCH_ALL else
+#define CPP_PTHREAD_RETHROW (void) 0
+#endif
 
 
 namespace pthread {
@@ -148,6 +163,26 @@ namespace pthread {
         explicit thread_exception(const std::string &message, const int pthread_error = -1);
     };
 
+    /** \name Report an error condition.
+     *
+     * The exception is thrown. When the library is built without exceptions (see CMake option CPP_PTHREAD_NO_EXCEPTIONS),
+     * the error message is printed on stderr and the process is aborted. Use the methods that take a `std::error_code`
+     * argument to handle errors without exceptions.
+     *
+     * These functions are compiled once, in the library: code built with exceptions and code built without them can be
+     * linked together, the library's build mode decides. There is one overload per exception class, the exception is
+     * thrown with the type of the overload.
+     *
+     * @{
+     */
+    [[noreturn]] void throw_exception(const pthread_exception &exception);
+    [[noreturn]] void throw_exception(const timeout_exception &exception);
+    [[noreturn]] void throw_exception(const mutex_exception &exception);
+    [[noreturn]] void throw_exception(const read_write_lock_exception &exception);
+    [[noreturn]] void throw_exception(const condition_variable_exception &exception);
+    [[noreturn]] void throw_exception(const thread_exception &exception);
+    /** @} */
+
     namespace util {
 
         /** \addtogroup exception
@@ -210,6 +245,14 @@ namespace pthread {
         /** @} */
     }; // namespace util
 
+    /** \name Report a synchronized queue error condition (see throw_exception(const pthread_exception &)).
+     * @{
+     */
+    [[noreturn]] void throw_exception(const util::queue_exception &exception);
+    [[noreturn]] void throw_exception(const util::queue_full &exception);
+    [[noreturn]] void throw_exception(const util::queue_timeout &exception);
+    /** @} */
+
     /** @} */
 
 } // namespace pthread
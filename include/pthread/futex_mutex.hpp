@@ -0,0 +1,220 @@
+//
+//  futex_mutex.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_futex_mutex_hpp
+#define pthread_futex_mutex_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#if defined(__linux__)
+
+/** defined when pthread::futex_mutex and pthread::futex_condition_variable are available (Linux only). */
+#define CPP_PTHREAD_HAVE_FUTEX 1
+
+#include <atomic>
+#include <cstdint>
+
+#include "pthread/lock_guard.hpp"
+#include "pthread/condition_variable.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    class futex_condition_variable;
+
+    /** Lightweight mutex built on a Linux futex.
+     *
+     * A futex_mutex is a single 32 bits word (a pthread::mutex is 40 bytes plus a vtable pointer). Locking and unlocking an
+     * uncontended futex_mutex is done inline, with a single atomic instruction, the kernel is only called when threads
+     * actually have to wait. It's meant for structures that embed many fine grained locks.
+     *
+     * The state word is
+     * - 0 unlocked
+     * - 1 locked, no waiters
+     * - 2 locked, threads may be waiting
+     *
+     * futex_mutex is not recursive, has no owner checks and never throws. Use it with lock_guard and futex_condition_variable.
+     *
+     * <pre><code>
+     * pthread::futex_mutex mtx;
+     * {
+     *   pthread::lock_guard<pthread::futex_mutex> lck(mtx);
+     *   ...
+     * }
+     * </code></pre>
+     *
+     * @see futex(2)
+     */
+    class futex_mutex {
+
+        friend class futex_condition_variable;
+
+    public:
+
+        /** Lock the mutex, blocks until it's available.
+         */
+        void lock() noexcept {
+            std::uint32_t state = 0;
+            if (!_state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                lock_contended(state);
+            }
+        }
+
+        /** Try to lock the mutex.
+         *
+         * @return true if the mutex is now locked, false if it is held by some thread.
+         */
+        bool try_lock() noexcept {
+            std::uint32_t state = 0;
+            return _state.compare_exchange_strong(state, 1, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        /** Release the mutex, one waiting thread (if any) is woken up.
+         */
+        void unlock() noexcept {
+            if (_state.fetch_sub(1, std::memory_order_release) != 1) {
+                unlock_contended();
+            }
+        }
+
+        /** create an unlocked mutex. */
+        futex_mutex() noexcept: _state(0) {
+        }
+
+        /** not copy-assignable */
+        futex_mutex(const futex_mutex &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const futex_mutex &) = delete;
+
+    private:
+
+        /** wait for the mutex (slow path).
+         *
+         * @param state last state that was read.
+         */
+        void lock_contended(std::uint32_t state) noexcept;
+
+        /** wake up a waiting thread (slow path). */
+        void unlock_contended() noexcept;
+
+        std::atomic<std::uint32_t> _state;
+    };
+
+    /** Condition variable to be used with a futex_mutex.
+     *
+     * Same semantic as pthread::condition_variable, the state is a single 32 bits sequence number that is incremented
+     * each time the condition is notified. Methods never throw.
+     */
+    class futex_condition_variable {
+    public:
+
+        /** Wait for condition to be signaled.
+         *
+         * The mutex is released while waiting and locked again on return.
+         *
+         * @param mtx related mutex, which must be locked by the current thread.
+         */
+        void wait(futex_mutex &mtx) noexcept;
+
+        /** Wait for condition to be signaled.
+         *
+         * @param lck related lock_guard.
+         */
+        void wait(lock_guard<futex_mutex> &lck) noexcept {
+            wait(*(lck._mutex));
+        }
+
+        /** Wait for lambda to return true (handles spurious wake ups).
+         *
+         * @param mtx related mutex, which must be locked by the current thread.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return true
+         */
+        template<class Lambda>
+        bool wait(futex_mutex &mtx, Lambda lambda) {
+            while (!lambda()) {
+                wait(mtx);
+            }
+            return true;
+        }
+
+        /** Wait for condition to be signaled within given time frame.
+         *
+         * @param mtx related mutex, which must be locked by the current thread.
+         * @param millis milliseconds to wait for this instance to be signaled.
+         * @return cv_status (either timeout or no_timeout)
+         */
+        cv_status wait_for(futex_mutex &mtx, int millis) noexcept;
+
+        /** Wait, at most millis milliseconds, for lambda to return true.
+         *
+         * The deadline is computed once, spurious wake ups don't extend the wait.
+         *
+         * @param mtx related mutex, which must be locked by the current thread.
+         * @param millis milliseconds to wait.
+         * @param lambda code that checks if the condition is met (bool lambda()).
+         * @return the value returned by the last call to lambda.
+         */
+        template<class Lambda>
+        bool wait_for(futex_mutex &mtx, int millis, Lambda lambda);
+
+        /** unblock one waiting thread (if any). */
+        void notify_one() noexcept;
+
+        /** unblock all waiting threads. */
+        void notify_all() noexcept;
+
+        /** construct a new condition variable. */
+        futex_condition_variable() noexcept: _sequence(0) {
+        }
+
+        /** not copy-assignable */
+        futex_condition_variable(const futex_condition_variable &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const futex_condition_variable &) = delete;
+
+    private:
+
+        /** wait until notified or the monotonic clock reaches deadline_nanos (0 means no deadline).
+         *
+         * @return cv_status::timedout if the deadline was reached.
+         */
+        cv_status wait_until(futex_mutex &mtx, std::int64_t deadline_nanos) noexcept;
+
+        /** @return current value of CLOCK_MONOTONIC in nanoseconds. */
+        static std::int64_t monotonic_nanos() noexcept;
+
+        std::atomic<std::uint32_t> _sequence;
+    };
+
+    /** @} */
+
+    // template implementation ----------------------
+
+    template<class Lambda>
+    bool futex_condition_variable::wait_for(futex_mutex &mtx, int millis, Lambda lambda) {
+        std::int64_t deadline = monotonic_nanos() + static_cast<std::int64_t>(millis) * 1000000;
+
+        bool stop_waiting = lambda();
+        while (!stop_waiting && wait_until(mtx, deadline) == no_timeout) {
+            stop_waiting = lambda();
+        }
+
+        return stop_waiting || lambda();
+    }
+
+} // namespace pthread
+
+#endif /* __linux__ */
+
+#endif /* pthread_futex_mutex_hpp */
@@ -0,0 +1,140 @@
+//
+//  left_right.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_left_right_hpp
+#define pthread_left_right_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <utility>
+
+#include "pthread/mutex.hpp"
+#include "pthread/lock_guard.hpp"
+#include "pthread/read_indicator.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Left-right concurrency control: wait-free readers, a single writer at a time.
+     *
+     * Two copies of the data are kept. Readers always read the copy that the writer is not changing, they never wait nor
+     * retry, and they only write to a reader slot that is on its own cache line. The writer applies each modification to
+     * the copy readers don't use, switches the readers to it, waits for the readers of the other copy to leave and then
+     * applies the same modification to that copy.
+     *
+     * The memory used is exactly twice the data (no garbage to collect), and each modification is run twice: modifiers
+     * must be deterministic (i.e. insert the same key and value in both copies).
+     *
+     * <pre><code>
+     * pthread::left_right<std::map<std::string, int>> routes;
+     *
+     * routes.modify([](std::map<std::string, int> &map) { map["eth0"] = 1; });                 // writer
+     * int port = routes.read([](const std::map<std::string, int> &map) { return map.at("eth0"); }); // readers
+     * </code></pre>
+     *
+     * @tparam T type of the data (copy constructible).
+     * @see P. Ramalhete and A. Correia, Left-Right: A Concurrency Control Technique with Wait-Free Population Oblivious Reads.
+     */
+    template<class T>
+    class left_right {
+    public:
+
+        /** run reader on the copy that is not being modified (wait-free).
+         *
+         * @param reader code that reads the data (R reader(const T &)), the reference must not be kept after it returns.
+         * @return what reader returned.
+         */
+        template<class Reader>
+        auto read(Reader reader) const -> decltype(reader(std::declval<const T &>())) {
+            reading guard(_indicators[_version.load(std::memory_order_seq_cst)]);
+            return reader(_instances[_left_right.load(std::memory_order_seq_cst)]);
+        }
+
+        /** apply modifier to both copies, one after the other (writers are serialized, readers don't wait).
+         *
+         * @param modifier code that changes the data (void modifier(T &)), it's called twice and must do the same thing each
+         *        time (if the first call throws, the data is unchanged, the second call must not throw).
+         * @throw mutex_exception if the writers' mutex can't be locked.
+         */
+        template<class Modifier>
+        void modify(Modifier modifier) {
+            pthread::lock_guard<pthread::mutex> lock(_writers);
+
+            const int left_right = _left_right.load(std::memory_order_relaxed);
+            modifier(_instances[1 - left_right]);
+
+            _left_right.store(1 - left_right, std::memory_order_seq_cst); // new readers read the modified copy
+            toggle_version_and_wait();
+
+            modifier(_instances[left_right]); // no reader left on this copy
+        }
+
+        /** create the two copies.
+         *
+         * @param value initial value of both copies.
+         */
+        explicit left_right(const T &value = T()) : _instances{value, value}, _left_right(0), _version(0) {
+        }
+
+        /** not copy-assignable */
+        left_right(const left_right &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const left_right &) = delete;
+
+    private:
+
+        /** a reader's stay (arrive on construction, depart on destruction). */
+        class reading {
+        public:
+            explicit reading(detail::read_indicator &indicator) noexcept: _indicator(indicator) {
+                _indicator.arrive();
+            }
+
+            ~reading() {
+                _indicator.depart();
+            }
+
+            reading(const reading &) = delete;
+
+            void operator=(const reading &) = delete;
+
+        private:
+            detail::read_indicator &_indicator;
+        };
+
+        /** make new readers use the other read indicator, and wait for the readers of both versions to leave. */
+        void toggle_version_and_wait() noexcept {
+            const int previous = _version.load(std::memory_order_relaxed);
+            const int next = 1 - previous;
+
+            wait_for_readers(_indicators[next]); // readers that are late from the version before
+            _version.store(next, std::memory_order_seq_cst);
+            wait_for_readers(_indicators[previous]);
+        }
+
+        static void wait_for_readers(const detail::read_indicator &indicator) noexcept {
+            indicator.wait_until_empty();
+        }
+
+        T _instances[2];                               //!< the two copies of the data
+        std::atomic<int> _left_right;                  //!< copy read by readers
+        std::atomic<int> _version;                     //!< read indicator used by arriving readers
+        mutable detail::read_indicator _indicators[2]; //!< readers of each version
+        pthread::mutex _writers;                       //!< serializes writers
+    };
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_left_right_hpp */
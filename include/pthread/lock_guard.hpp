@@ -22,6 +22,22 @@ namespace pthread {
      * @{
      */
 
+    /** tag type, the lock doesn't lock the mutex (see unique_lock). */
+    struct defer_lock_t {
+    };
+
+    /** tag type, the lock tries to lock the mutex without blocking (see unique_lock). */
+    struct try_to_lock_t {
+    };
+
+    /** tag type, the calling thread already holds the mutex (see lock_guard and unique_lock). */
+    struct adopt_lock_t {
+    };
+
+    constexpr defer_lock_t defer_lock{};   //!< don't lock the mutex
+    constexpr try_to_lock_t try_to_lock{}; //!< try to lock the mutex without blocking
+    constexpr adopt_lock_t adopt_lock{};   //!< the mutex is already locked by the calling thread
+
     /**
      * This class was designed to encapsulate a mutex and automatically control the lock attribute.
      *
@@ -37,6 +53,7 @@ namespace pthread {
     class lock_guard {
 
         friend class condition_variable;
+        friend class futex_condition_variable;
 
     public:
         /**
@@ -52,6 +69,13 @@ namespace pthread {
             _mutex->lock();
         }
 
+        /** Take ownership of a mutex that the calling thread already locked (i.e. with pthread::lock).
+         *
+         * @param mutex reference to a mutex locked by the calling thread.
+         */
+        lock_guard(MutexType &mutex, adopt_lock_t) noexcept: _mutex(&mutex) {
+        }
+
         /** The destructor release the guarded mutex.
          *
          * @see mutex#unlock
@@ -0,0 +1,426 @@
+//
+//  lock_profile.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_lock_profile_hpp
+#define pthread_lock_profile_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "pthread/mutex.hpp"
+#include "pthread/read_write_lock.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** number of buckets of a lock_statistics histogram.
+     *
+     * Bucket 0 counts durations of 0ns, bucket i (i > 0) counts durations in [2^(i-1), 2^i) nanoseconds. The last bucket
+     * also counts longer durations.
+     */
+    const std::size_t lock_histogram_buckets = 40;
+
+    /** log2 histogram of durations (see lock_histogram_buckets). */
+    typedef std::array<std::uint64_t, lock_histogram_buckets> lock_histogram;
+
+    /** What a lock_profile recorded so far.
+     */
+    struct lock_statistics {
+        std::string name;                   //!< name of the lock
+        std::uint64_t acquisitions;         //!< number of times the lock was acquired
+        std::uint64_t contended;            //!< number of acquisitions that had to wait because the lock was held
+        std::chrono::nanoseconds wait_time; //!< total time spent waiting for the lock
+        std::chrono::nanoseconds max_wait;  //!< longest wait
+        std::chrono::nanoseconds hold_time; //!< total time the lock was held (exclusive locks only)
+        lock_histogram wait_histogram;      //!< time spent waiting, per acquisition
+        lock_histogram hold_histogram;      //!< time the lock was held, per exclusive acquisition
+    };
+
+    /** Lock contention counters of a named lock.
+     *
+     * A profiled_mutex or a profiled_read_write_lock owns a lock_profile, which records every acquisition made through
+     * lock(), try_lock() or a lock_guard. A plain mutex or read_write_lock is not instrumented and doesn't pay for it.
+     *
+     * Counters are sharded: each thread updates the shard it was assigned to, with relaxed atomic operations, so profiling
+     * doesn't add a shared cache line to the lock's own. The shards are summed when statistics are read.
+     *
+     * <pre><code>
+     * pthread::profiled_mutex orders_mutex{"orders"};
+     * pthread::profiled_read_write_lock catalog_lock{"catalog"};
+     * ...
+     * pthread::lock_profile::report(std::cout, 5); // prints the 5 most contended locks
+     * </code></pre>
+     */
+    class lock_profile {
+    public:
+
+        /** record an acquisition.
+         *
+         * @param contended true if the lock was held by some other thread.
+         * @param wait time spent waiting for the lock.
+         */
+        void acquired(bool contended, std::chrono::nanoseconds wait) noexcept;
+
+        /** record how long an exclusive lock was held.
+         *
+         * @param hold time between the acquisition and the release.
+         */
+        void released(std::chrono::nanoseconds hold) noexcept;
+
+        /** @return the name of the profiled lock. */
+        const std::string &name() const {
+            return _name;
+        }
+
+        /** @return counters summed over all shards. */
+        lock_statistics statistics() const;
+
+        /** set all counters to zero. */
+        void reset() noexcept;
+
+        /** @return the statistics of the live profiled locks, most contended (then longest waits) first.
+         *
+         * @param count maximum number of locks returned.
+         */
+        static std::vector<lock_statistics> top_contended(std::size_t count = 10);
+
+        /** print the most contended locks (name, acquisitions, contention rate, average and max wait, average hold time).
+         *
+         * @param out where to print the report.
+         * @param count maximum number of locks printed.
+         */
+        static void report(std::ostream &out, std::size_t count = 10);
+
+        /** create a profile and register it (see top_contended).
+         *
+         * @param name name of the profiled lock.
+         */
+        explicit lock_profile(const std::string &name);
+
+        /** unregister the profile. */
+        ~lock_profile();
+
+        /** not copy-assignable */
+        lock_profile(const lock_profile &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const lock_profile &) = delete;
+
+        /** counters updated by a subset of the threads. */
+        struct shard;
+
+    private:
+
+        /** @return the calling thread's shard. */
+        shard &local_shard() noexcept;
+
+        std::string _name;
+        shard *_shards;
+    };
+
+    /** A mutex that records its contention in a lock_profile.
+     *
+     * Acquisitions, contention and wait times are recorded by lock() and try_lock(), the time the mutex is held by
+     * unlock(). Re-entering a recursive mutex counts as an acquisition, its hold time is measured from the outermost
+     * lock() to the matching unlock(). A condition_variable wait doesn't count as hold time.
+     *
+     * <pre><code>
+     * pthread::profiled_mutex orders_mutex{"orders"};
+     *
+     * {
+     *   pthread::lock_guard<pthread::profiled_mutex> lock(orders_mutex);
+     *   ...
+     * }
+     * </code></pre>
+     *
+     * > *WARN* only the lock(), try_lock() and unlock() methods of this class are profiled, locking it through a reference
+     * > to mutex bypasses the profile.
+     */
+    class profiled_mutex final : public mutex {
+
+        friend class condition_variable;
+
+    public:
+
+        /** Lock the mutex and record the acquisition.
+         *
+         * @throw mutex_exception if error conditions preventing this method to succeed (see mutex::lock()).
+         */
+        void lock();
+
+        /** Lock the mutex, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_mutex_lock, cleared on success (see mutex::lock(std::error_code &)).
+         */
+        void lock(std::error_code &ec) noexcept;
+
+        /** Try to lock the mutex, record the acquisition if it succeeded.
+         *
+         * @return true if the mutex is locked, false is returned if the lock is held by some other thread.
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock();
+
+        /** Try to lock the mutex, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_mutex_trylock (EBUSY is not an error), cleared on success.
+         * @return true if the mutex is locked, false if it is held by some other thread or on error.
+         */
+        bool try_lock(std::error_code &ec) noexcept;
+
+        /** Record the time the mutex was held and release it.
+         *
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        void unlock();
+
+        /** Release the mutex, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_mutex_unlock (i.e. EPERM), cleared on success.
+         */
+        void unlock(std::error_code &ec) noexcept;
+
+        /** @return the contention counters of this mutex. */
+        lock_profile &profile() noexcept {
+            return _profile;
+        }
+
+        /** create and initialize a profiled mutex.
+         *
+         * @param name name of the mutex in lock contention reports.
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        explicit profiled_mutex(const std::string &name);
+
+        /** create and initialize a profiled mutex with the given attributes.
+         *
+         * @param name name of the mutex in lock contention reports.
+         * @param attributes mutex attributes (type, robustness, ...)
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        profiled_mutex(const std::string &name, const mutex_attributes &attributes);
+
+    private:
+
+        /** record a successful acquisition.
+         *
+         * @param contended true if the mutex was held by some other thread.
+         * @param since when the calling thread started to wait for the mutex.
+         */
+        void acquired(bool contended, std::chrono::steady_clock::time_point since) noexcept;
+
+        /** the owner is about to unlock the mutex, record the hold time when the outermost lock is released. */
+        void releasing() noexcept;
+
+        /** a condition_variable wait is about to release mtx, record the hold time if it's a profiled mutex.
+         *
+         * @return the profiled mutex the calling thread holds at address mtx, nullptr if mtx isn't a profiled mutex.
+         */
+        static profiled_mutex *waiting(const mutex &mtx) noexcept;
+
+        /** a condition_variable wait locked the mutex again, restart its hold timer.
+         *
+         * @param mtx the profiled mutex returned by waiting() (nothing is done if it's nullptr).
+         */
+        static void woken(profiled_mutex *mtx) noexcept;
+
+        lock_profile _profile;
+        std::chrono::steady_clock::time_point _acquired_at; //!< when the owner locked the mutex (outermost lock)
+        unsigned _depth;                                    //!< number of times the owner locked the mutex
+        profiled_mutex *_next_held;                         //!< next profiled mutex held by the owner (see waiting())
+    };
+
+    /** The read side of a profiled_read_write_lock.
+     *
+     * Read acquisitions, contention and wait times are recorded. As readers share the lock, their hold time isn't.
+     *
+     * @see profiled_read_write_lock
+     */
+    class profiled_read_lock {
+    public:
+
+        /** apply a read lock and record the acquisition.
+         *
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        void lock();
+
+        /** apply a read lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_rdlock, cleared on success.
+         */
+        void lock(std::error_code &ec) noexcept;
+
+        /** try to apply a read lock, record the acquisition if it succeeded.
+         *
+         * @return true if the read lock was acquired, false if a writer holds the lock.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock();
+
+        /** try to apply a read lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_tryrdlock (EBUSY is not an error), cleared on success.
+         * @return true if the read lock was acquired, false if a writer holds the lock or on error.
+         */
+        bool try_lock(std::error_code &ec) noexcept;
+
+        /** release the read lock.
+         *
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        void unlock();
+
+        /** release the read lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_unlock, cleared on success.
+         */
+        void unlock(std::error_code &ec) noexcept;
+
+        /** @return the contention counters of this lock. */
+        lock_profile &profile() noexcept {
+            return _profile;
+        }
+
+        /** not copy-assignable */
+        profiled_read_lock(const profiled_read_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const profiled_read_lock &) = delete;
+
+    protected:
+
+        /** create a profiled read/write lock.
+         *
+         * @param name name of the lock in lock contention reports.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        explicit profiled_read_lock(const std::string &name);
+
+        /** create a profiled read/write lock that follows the given policy.
+         *
+         * @param name name of the lock in lock contention reports.
+         * @param policy prefer readers or writers.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        profiled_read_lock(const std::string &name, rwlock_policy policy);
+
+        /** not virtual, a profiled_read_lock is always destroyed as a profiled_write_lock. */
+        ~profiled_read_lock() = default;
+
+        /** record a successful acquisition.
+         *
+         * @param contended true if the lock was held by some other thread.
+         * @param since when the calling thread started to wait for the lock.
+         */
+        void acquired(bool contended, std::chrono::steady_clock::time_point since) noexcept;
+
+        read_write_lock _rwlock;
+        lock_profile _profile;
+    };
+
+    /** A read/write lock that records its contention in a lock_profile.
+     *
+     * Read and write acquisitions, contention and wait times are recorded, as well as the time the write lock is held.
+     *
+     * <pre><code>
+     * pthread::profiled_read_write_lock catalog_lock{"catalog"};
+     *
+     * {
+     *   pthread::lock_guard<pthread::profiled_read_lock> lock(catalog_lock);
+     *   ...
+     * }
+     * {
+     *   pthread::lock_guard<pthread::profiled_write_lock> lock(catalog_lock);
+     *   ...
+     * }
+     * </code></pre>
+     */
+    class profiled_write_lock final : public profiled_read_lock {
+    public:
+
+        /** apply a write lock and record the acquisition.
+         *
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        void lock();
+
+        /** apply a write lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_wrlock, cleared on success.
+         */
+        void lock(std::error_code &ec) noexcept;
+
+        /** try to apply a write lock, record the acquisition if it succeeded.
+         *
+         * @return true if the write lock was acquired, false if the lock is held.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock();
+
+        /** try to apply a write lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_trywrlock (EBUSY is not an error), cleared on success.
+         * @return true if the write lock was acquired, false if the lock is held or on error.
+         */
+        bool try_lock(std::error_code &ec) noexcept;
+
+        /** record the time the write lock was held and release it.
+         *
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        void unlock();
+
+        /** release the write lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_unlock, cleared on success.
+         */
+        void unlock(std::error_code &ec) noexcept;
+
+        /** create a profiled read/write lock.
+         *
+         * @param name name of the lock in lock contention reports.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        explicit profiled_write_lock(const std::string &name);
+
+        /** create a profiled read/write lock that prefers either readers or writers.
+         *
+         * @param name name of the lock in lock contention reports.
+         * @param policy prefer readers or writers.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        profiled_write_lock(const std::string &name, rwlock_policy policy);
+
+    private:
+
+        /** record a successful acquisition of the write lock. */
+        void acquired(bool contended, std::chrono::steady_clock::time_point since) noexcept;
+
+        std::chrono::steady_clock::time_point _acquired_at; //!< when the writer locked the lock
+    };
+
+    /** A read/write lock that records its contention (see profiled_write_lock). */
+    typedef profiled_write_lock profiled_read_write_lock;
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_lock_profile_hpp */
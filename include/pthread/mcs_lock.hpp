@@ -0,0 +1,82 @@
+//
+//  mcs_lock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_mcs_lock_hpp
+#define pthread_mcs_lock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** MCS queue lock (Mellor-Crummey and Scott).
+     *
+     * Waiting threads form a queue, each one spins on a flag that sits in its own cache line (instead of hammering a shared
+     * lock word). The lock is handed over to the next thread in line (FIFO), releasing it only touches the successor's cache
+     * line. This keeps throughput stable when tens of threads contend for the same critical section.
+     *
+     * A waiting thread spins for a while, then sleeps (futex on Linux, sched_yield elsewhere) until its predecessor hands
+     * the lock over.
+     *
+     * Queue nodes are taken from a small per-thread pool (a thread can hold several mcs_lock at the same time), so mcs_lock
+     * follows the usual lock/try_lock/unlock contract:
+     *
+     * <pre><code>
+     * pthread::mcs_lock lock;
+     * {
+     *   pthread::lock_guard<pthread::mcs_lock> guard(lock);
+     *   ...
+     * }
+     * </code></pre>
+     *
+     * > *WARN* the thread that locked an mcs_lock must be the one that unlocks it.
+     */
+    class mcs_lock {
+    public:
+
+        /** queue up and wait for the lock.
+         */
+        void lock() noexcept;
+
+        /** @return true if the lock was free (and is now held), false otherwise.
+         */
+        bool try_lock() noexcept;
+
+        /** hand the lock over to the next waiting thread (if any).
+         */
+        void unlock() noexcept;
+
+        /** create an unlocked lock. */
+        mcs_lock() noexcept: _tail(nullptr), _owner(nullptr) {
+        }
+
+        /** not copy-assignable */
+        mcs_lock(const mcs_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const mcs_lock &) = delete;
+
+        /** queue node (one per waiting or owning thread). */
+        struct node;
+
+    private:
+
+        std::atomic<node *> _tail; //!< last thread in line, nullptr when the lock is free
+        node *_owner;              //!< node of the thread that holds the lock
+    };
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_mcs_lock_hpp */
@@ -13,6 +13,7 @@
 // recommandation for more info p.285 chapter 8.3.1).
 #include <pthread.h>
 
+#include <chrono>
 #include <exception>
 #include <string>
 
@@ -28,6 +29,127 @@ namespace pthread {
 
     class condition_variable;
 
+    namespace detail {
+
+        /** @return now + duration on the steady clock, rounded up to the steady clock's resolution.
+         */
+        template<class Rep, class Period>
+        std::chrono::steady_clock::time_point steady_deadline(const std::chrono::duration<Rep, Period> &duration) {
+            auto delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+            if (delay < duration) {
+                ++delay; // waiting less than asked would be a timeout too early
+            }
+            return std::chrono::steady_clock::now() + delay;
+        }
+
+        /** @return deadline converted into a steady clock deadline (it doesn't move if Clock is changed afterwards).
+         */
+        template<class Clock, class Duration>
+        std::chrono::steady_clock::time_point steady_deadline(const std::chrono::time_point<Clock, Duration> &deadline) {
+            return steady_deadline(deadline - Clock::now());
+        }
+
+        /** @return deadline */
+        inline std::chrono::steady_clock::time_point steady_deadline(std::chrono::steady_clock::time_point deadline) noexcept {
+            return deadline;
+        }
+    }
+
+    /** kind of mutex (see mutex_attributes::type).
+     */
+    enum class mutex_type {
+        normal,      /*!< default mutex (PTHREAD_MUTEX_DEFAULT) */
+        recursive,   /*!< the owner can lock the mutex several times, it must unlock it as many times (PTHREAD_MUTEX_RECURSIVE) */
+        error_check, /*!< relocking or unlocking a mutex that the caller doesn't own is reported as an error (PTHREAD_MUTEX_ERRORCHECK) */
+        adaptive     /*!< spin a while before sleeping, for short critical sections (PTHREAD_MUTEX_ADAPTIVE_NP, glibc only) */
+    };
+
+    /** priority protocol of a mutex (see mutex_attributes::protocol).
+     */
+    enum class mutex_protocol {
+        none,    /*!< owning the mutex doesn't change the owner's priority (PTHREAD_PRIO_NONE) */
+        inherit, /*!< the owner runs at the priority of the highest priority thread waiting for the mutex (PTHREAD_PRIO_INHERIT) */
+        protect  /*!< the owner runs at least at the mutex priority ceiling (PTHREAD_PRIO_PROTECT) */
+    };
+
+    /** Mutex attributes.
+     *
+     * Setters can be chained:
+     * <pre><code>
+     * pthread::mutex mtx{pthread::mutex_attributes().type(pthread::mutex_type::adaptive)};
+     * </code></pre>
+     *
+     * @see pthread_mutexattr_init
+     */
+    class mutex_attributes {
+
+        friend class mutex;
+
+    public:
+
+        /** set the kind of mutex.
+         *
+         * @param type kind of mutex (default is mutex_type::normal).
+         * @return this instance
+         * @throw mutex_exception if the type is not supported (i.e. adaptive mutexes are glibc specific).
+         * @see pthread_mutexattr_settype
+         */
+        mutex_attributes &type(mutex_type type);
+
+        /** make the mutex robust.
+         *
+         * When the owner of a robust mutex dies while holding it, the next thread that locks the mutex gets the lock and
+         * mutex::owner_died() returns true. This thread must then repair the protected data, call mutex::consistent() and
+         * unlock the mutex.
+         *
+         * @param robust true if the mutex must be robust.
+         * @return this instance
+         * @throw mutex_exception if robust mutexes are not supported.
+         * @see pthread_mutexattr_setrobust
+         */
+        mutex_attributes &robust(bool robust = true);
+
+        /** set the priority protocol.
+         *
+         * Priority inheritance bounds priority inversion: a low priority thread that holds a mutex needed by a high priority
+         * thread is boosted until it releases the mutex, medium priority threads can't preempt it meanwhile.
+         *
+         * @param protocol priority protocol (default is mutex_protocol::none).
+         * @return this instance
+         * @throw mutex_exception if the protocol is not supported.
+         * @see pthread_mutexattr_setprotocol
+         */
+        mutex_attributes &protocol(mutex_protocol protocol);
+
+        /** set the priority ceiling used by the mutex_protocol::protect protocol.
+         *
+         * @param ceiling a real-time priority (see sched_get_priority_min(SCHED_FIFO) and sched_get_priority_max(SCHED_FIFO)).
+         * @return this instance
+         * @throw mutex_exception if the ceiling is invalid or priority protection is not supported.
+         * @see pthread_mutexattr_setprioceiling
+         */
+        mutex_attributes &priority_ceiling(int ceiling);
+
+        /** initialize attributes with their default values.
+         *
+         * @throw mutex_exception if pthread_mutexattr_init failed.
+         */
+        mutex_attributes();
+
+        /** @see pthread_mutexattr_destroy
+         */
+        ~mutex_attributes();
+
+        /** not copy-assignable */
+        mutex_attributes(const mutex_attributes &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const mutex_attributes &) = delete;
+
+    private:
+        pthread_mutexattr_t _attributes;
+    };
+
     /** The mutex class is a synchronization primitive that can be used to protect shared data from being simultaneously accessed by multiple threads.
      *
      * @author herbert koelman
@@ -43,18 +165,33 @@ namespace pthread {
          * The mutex object is locked (by calling pthread_mutex_lock). If the mutex is already locked, the calling thread blocks until the mutex becomes
          * available. This operation returns with the mutex object referenced by mutex in the locked state with the calling thread as its owner.
          *
-         * @throw mutex_exception if error conditions preventing this method to succeed.
+         * If the mutex is robust and its previous owner died while holding it, the method returns normally: the calling
+         * thread owns the mutex and owner_died() returns true. The caller must repair the protected data and call
+         * consistent() before it unlocks the mutex, otherwise the mutex becomes permanently unusable (ENOTRECOVERABLE).
+         * This way a lock_guard always releases a mutex it acquired.
+         *
+         * @throw mutex_exception if error conditions preventing this method to succeed (the mutex is not locked then).
+         * @see owner_died
          * @see unlock
          * @see pthread_mutex_lock
          */
         void lock();
 
+        /** Lock the mutex, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_mutex_lock, cleared on success. If ec is EOWNERDEAD, the mutex is robust and is
+         *        now locked (see owner_died()).
+         * @see lock()
+         */
+        void lock(std::error_code &ec) noexcept;
+
         /** Try to lock the mutex.
          *
          * Identical to lock method except that if the mutex object is currently locked (by any thread, including the
          * current thread), the call returns immediately.
          *
-         * @return true if the mutex is locked, false is returned if the lock is held by some other thread.
+         * @return true if the mutex is locked (owner_died() tells if its previous owner died while holding it), false is
+         *         returned if the lock is held by some other thread.
          * @throw mutex_exception if error conditions preventing this method to succeed.
          * @see lock
          * @see unlock
@@ -62,6 +199,14 @@ namespace pthread {
          */
         bool try_lock();
 
+        /** Try to lock the mutex, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_mutex_trylock (EBUSY is not an error), cleared on success.
+         * @return true if the mutex is locked, false if it is held by some other thread or on error.
+         * @see try_lock()
+         */
+        bool try_lock(std::error_code &ec) noexcept;
+
         /** Release the mutex.
          *
          * Releases the mutex object referenced by mutex.  The manner in which a mutex is released is dependent upon the mutex's
@@ -73,20 +218,57 @@ namespace pthread {
          */
         void unlock();
 
+        /** Release the mutex, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_mutex_unlock (i.e. EPERM), cleared on success.
+         * @see unlock()
+         */
+        void unlock(std::error_code &ec) noexcept;
+
+        /** Mark the state protected by a robust mutex as consistent.
+         *
+         * Must be called by the thread that locked a robust mutex which owner died (see owner_died()), once the protected
+         * data was repaired. If the mutex is unlocked without calling this method, it becomes permanently unusable
+         * (ENOTRECOVERABLE).
+         *
+         * @throw mutex_exception if the mutex is not robust or not in an inconsistent state.
+         * @see mutex_attributes::robust
+         * @see pthread_mutex_consistent
+         */
+        void consistent();
+
+        /** @return true if the calling thread locked this robust mutex after its previous owner died while holding it, and
+         *          didn't call consistent() yet. Only the thread that owns the mutex may call this method.
+         */
+        bool owner_died() const noexcept {
+            return _owner_died;
+        }
+
         /** create and initialize a mutex.
          *
-         * > *WARN* the default mutex attributes are used.
+         * > *WARN* the default mutex attributes are used (see mutex(const mutex_attributes &)).
          * 
          * @throw mutex_exception if error conditions preventing this method to succeed.
          * @see pthread_mutex_init
          */
         mutex();
 
+        /** create and initialize a mutex with the given attributes.
+         *
+         * @param attributes mutex attributes (type, robustness, ...)
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         * @see pthread_mutex_init
+         */
+        explicit mutex(const mutex_attributes &attributes);
+
         /** destroys the mutex.
+         *
+         * > *WARN* the destructor is not virtual (mutex has no vtable): deleting a derived mutex (i.e. a timed_mutex) through a
+         * > pointer to mutex is undefined behavior.
          *
          * @see pthread_mutex_destroy
          */
-        virtual ~mutex();
+        ~mutex();
 
         /** not copy-assignable, so no copy contructor is needed.
          *
@@ -99,8 +281,217 @@ namespace pthread {
         void operator=(const mutex &) = delete;
 
     protected:
+
         /** pthread mutex structure */
         pthread_mutex_t _mutex;
+
+        bool _owner_died; //!< the owner locked this robust mutex after its previous owner died (see owner_died())
+
+    private:
+
+        /** handle an error returned by pthread_mutex_lock (cold path).
+         *
+         * Returns if rc is EOWNERDEAD (the mutex is locked, see owner_died()), throws the matching mutex_exception otherwise.
+         */
+        void lock_failed(int rc);
+
+        /** handle an error returned by pthread_mutex_trylock (cold path), see lock_failed. */
+        void try_lock_failed(int rc);
+
+        /** throw the mutex_exception that matches the error returned by pthread_mutex_unlock (cold path). */
+        [[noreturn]] static void unlock_failed(int rc);
+    };
+
+    // inline implementation ----------------------
+    //
+    // lock, try_lock and unlock are inlined, so that an uncontended lock_guard costs no more than the pthread calls. Error
+    // handling is done out of line.
+
+    inline void mutex::lock() {
+        int rc = pthread_mutex_lock(&_mutex);
+        if (rc != 0) {
+            lock_failed(rc);
+        }
+    }
+
+    inline void mutex::lock(std::error_code &ec) noexcept {
+        int rc = pthread_mutex_lock(&_mutex);
+        if (rc == EOWNERDEAD) {
+            _owner_died = true;
+        }
+        ec.assign(rc, std::system_category());
+    }
+
+    inline bool mutex::try_lock() {
+        int rc = pthread_mutex_trylock(&_mutex);
+        if (rc == 0) {
+            return true; // mutex is locked now
+        } else if (rc == EBUSY) {
+            return false; // mutex is held by some other thread
+        }
+        try_lock_failed(rc);
+        return true; // the owner of this robust mutex died, the mutex is locked now
+    }
+
+    inline bool mutex::try_lock(std::error_code &ec) noexcept {
+        int rc = pthread_mutex_trylock(&_mutex);
+        if (rc == EBUSY) {
+            ec.clear(); // mutex is held by some other thread, this is not an error
+            return false;
+        } else if (rc == EOWNERDEAD) {
+            _owner_died = true;
+        }
+
+        ec.assign(rc, std::system_category());
+        return rc == 0 || rc == EOWNERDEAD; // mutex is locked now
+    }
+
+    inline void mutex::unlock() {
+        int rc = pthread_mutex_unlock(&_mutex);
+        if (rc != 0) {
+            unlock_failed(rc);
+        }
+    }
+
+    inline void mutex::unlock(std::error_code &ec) noexcept {
+        ec.assign(pthread_mutex_unlock(&_mutex), std::system_category());
+    }
+
+    /** A mutex that uses the priority inheritance protocol (PTHREAD_PRIO_INHERIT).
+     *
+     * Use it to protect data shared by threads that run with different (real-time) priorities, the latency of the high
+     * priority threads is then bounded by the length of the critical sections.
+     *
+     * @see mutex_protocol::inherit
+     */
+    class priority_inheritance_mutex final : public mutex {
+    public:
+
+        /** create and initialize a priority inheritance mutex.
+         *
+         * @throw mutex_exception if priority inheritance is not supported.
+         */
+        priority_inheritance_mutex() : mutex(mutex_attributes().protocol(mutex_protocol::inherit)) {
+        }
+    };
+
+    /** A mutex that uses the priority ceiling protocol (PTHREAD_PRIO_PROTECT).
+     *
+     * The owner of this mutex runs at least at the ceiling priority. Locking it changes the caller's scheduling priority:
+     * the caller must run with a real-time policy (SCHED_FIFO or SCHED_RR) and a priority that doesn't exceed the ceiling,
+     * lock() throws a mutex_exception (EINVAL) otherwise.
+     *
+     * @see mutex_protocol::protect
+     */
+    class priority_ceiling_mutex final : public mutex {
+    public:
+
+        /** create and initialize a priority ceiling mutex.
+         *
+         * @param ceiling priority ceiling (a SCHED_FIFO priority).
+         * @throw mutex_exception if the ceiling is invalid or priority protection is not supported.
+         */
+        explicit priority_ceiling_mutex(int ceiling) : mutex(mutex_attributes().protocol(mutex_protocol::protect).priority_ceiling(ceiling)) {
+        }
+    };
+
+    /** A mutex that can be waited for a limited amount of time.
+     *
+     * Deadlines are measured with the steady (monotonic) clock, wall clock adjustments don't shorten or extend the waits.
+     *
+     * <pre><code>
+     * pthread::timed_mutex mtx;
+     *
+     * if (mtx.try_lock_for(20)) {
+     *   ... // got the lock within 20ms
+     *   mtx.unlock();
+     * }
+     * </code></pre>
+     */
+    class timed_mutex final : public mutex {
+    public:
+
+        /** Try to lock the mutex, block at most millis milliseconds.
+         *
+         * @param millis milliseconds to wait for the mutex.
+         * @return true if the mutex is locked, false if the time out expired.
+         * @throw mutex_exception if error conditions preventing this method to succeed (see lock()).
+         * @see try_lock_until
+         */
+        bool try_lock_for(int millis);
+
+        /** Same as try_lock_for(int), errors are reported in ec instead of being thrown.
+         *
+         * @param millis milliseconds to wait for the mutex.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the mutex is locked, false if the time out expired or on error.
+         */
+        bool try_lock_for(int millis, std::error_code &ec) noexcept;
+
+        /** Try to lock the mutex, block until deadline is reached.
+         *
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @return true if the mutex is locked, false if the deadline was reached.
+         * @throw mutex_exception if error conditions preventing this method to succeed (see lock()).
+         * @see pthread_mutex_clocklock
+         * @see pthread_mutex_timedlock
+         */
+        bool try_lock_until(std::chrono::steady_clock::time_point deadline);
+
+        /** Same as try_lock_until(std::chrono::steady_clock::time_point), errors are reported in ec instead of being thrown.
+         *
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the mutex is locked, false if the deadline was reached or on error.
+         */
+        bool try_lock_until(std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept;
+
+        /** Try to lock the mutex, block at most for the given duration (i.e. std::chrono::microseconds(200)).
+         *
+         * @param duration time to wait for the mutex.
+         * @return true if the mutex is locked, false if the time out expired.
+         * @throw mutex_exception if error conditions preventing this method to succeed (see lock()).
+         */
+        template<class Rep, class Period>
+        bool try_lock_for(const std::chrono::duration<Rep, Period> &duration) {
+            return try_lock_until(detail::steady_deadline(duration));
+        }
+
+        /** Same as try_lock_for(const std::chrono::duration<Rep, Period> &), errors are reported in ec instead of being thrown.
+         *
+         * @param duration time to wait for the mutex.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the mutex is locked, false if the time out expired or on error.
+         */
+        template<class Rep, class Period>
+        bool try_lock_for(const std::chrono::duration<Rep, Period> &duration, std::error_code &ec) noexcept {
+            return try_lock_until(detail::steady_deadline(duration), ec);
+        }
+
+        /** Try to lock the mutex, block until deadline (of any clock) is reached.
+         *
+         * @param deadline point in time after which the calling thread gives up.
+         * @return true if the mutex is locked, false if the deadline was reached.
+         * @throw mutex_exception if error conditions preventing this method to succeed (see lock()).
+         */
+        template<class Clock, class Duration>
+        bool try_lock_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+            return try_lock_until(detail::steady_deadline(deadline));
+        }
+
+        /** create and initialize a timed mutex.
+         *
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        timed_mutex() = default;
+
+        /** create and initialize a timed mutex with the given attributes.
+         *
+         * @param attributes mutex attributes (type, robustness, ...)
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        explicit timed_mutex(const mutex_attributes &attributes) : mutex(attributes) {
+        }
     };
 
     /** @} */
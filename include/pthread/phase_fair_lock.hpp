@@ -0,0 +1,175 @@
+//
+//  phase_fair_lock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_phase_fair_lock_hpp
+#define pthread_phase_fair_lock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "pthread/spin_lock.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Phase fair read lock (see phase_fair_read_write_lock).
+     *
+     * This class cannot be instantiated, create a phase_fair_read_write_lock and pass it to a lock_guard<phase_fair_read_lock>
+     * to get a read lock.
+     */
+    class phase_fair_read_lock {
+    public:
+
+        /** apply a read lock, wait for the current writer (if any) to release the lock.
+         */
+        void lock() noexcept {
+            const std::uint32_t writer = _readers_in.fetch_add(reader_increment, std::memory_order_acquire) & writer_bits;
+            if (writer != 0) {
+                // a writer holds (or waits for) the lock, wait for the end of its phase
+                util::spin_wait([this, writer] { return (_readers_in.load(std::memory_order_acquire) & writer_bits) != writer; });
+            }
+        }
+
+        /** @return true if the read lock was acquired, false if a writer holds or waits for the lock.
+         */
+        bool try_lock() noexcept {
+            std::uint32_t readers_in = _readers_in.load(std::memory_order_relaxed);
+            return (readers_in & writer_bits) == 0 &&
+                   _readers_in.compare_exchange_strong(readers_in, readers_in + reader_increment, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        /** release the read lock.
+         */
+        void unlock() noexcept {
+            _readers_out.fetch_add(reader_increment, std::memory_order_release);
+        }
+
+        /** not copy-assignable */
+        phase_fair_read_lock(const phase_fair_read_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const phase_fair_read_lock &) = delete;
+
+    protected:
+
+        /** create an unlocked lock. */
+        phase_fair_read_lock() noexcept: _readers_in(0), _readers_out(0), _writers_in(0), _writers_out(0) {
+        }
+
+        /** not virtual, a phase_fair_read_write_lock can't be deleted through a pointer to its read lock. */
+        ~phase_fair_read_lock() = default;
+
+        static const std::uint32_t reader_increment = 0x100; //!< readers are counted above the writer bits
+        static const std::uint32_t writer_bits = 0x3;        //!< writer present and phase id
+        static const std::uint32_t writer_present = 0x2;     //!< a writer holds or waits for the lock
+        static const std::uint32_t phase_id = 0x1;           //!< tells two consecutive writers apart
+
+        std::atomic<std::uint32_t> _readers_in;  //!< readers that entered (times reader_increment) + writer bits
+        std::atomic<std::uint32_t> _readers_out; //!< readers that left (times reader_increment)
+        std::atomic<std::uint32_t> _writers_in;  //!< next writer ticket
+        std::atomic<std::uint32_t> _writers_out; //!< writer ticket being served
+    };
+
+    /** Phase fair write lock (see phase_fair_read_write_lock).
+     */
+    class phase_fair_write_lock : public phase_fair_read_lock {
+    public:
+
+        /** apply a write lock, writers are served in FIFO order.
+         *
+         * The writer first waits for its turn among writers, it then blocks new readers and waits for the readers of the
+         * current phase to leave.
+         */
+        void lock() noexcept {
+            const std::uint32_t ticket = _writers_in.fetch_add(1, std::memory_order_relaxed);
+            util::spin_wait([this, ticket] { return _writers_out.load(std::memory_order_acquire) == ticket; });
+
+            const std::uint32_t readers = _readers_in.fetch_add(writer_present | (ticket & phase_id), std::memory_order_acquire);
+            util::spin_wait([this, readers] { return _readers_out.load(std::memory_order_acquire) == readers; });
+        }
+
+        /** @return true if the write lock was acquired, false if the lock is held or some writer is waiting for it.
+         */
+        bool try_lock() noexcept {
+            std::uint32_t ticket = _writers_in.load(std::memory_order_relaxed);
+            if (_writers_out.load(std::memory_order_acquire) != ticket) {
+                return false;
+            }
+
+            std::uint32_t readers = _readers_in.load(std::memory_order_acquire);
+            if ((readers & writer_bits) != 0 || _readers_out.load(std::memory_order_acquire) != readers) {
+                return false;
+            }
+
+            if (!_writers_in.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return false;
+            }
+
+            if (_readers_in.compare_exchange_strong(readers, readers | writer_present | (ticket & phase_id), std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+
+            // a reader came in, give the ticket back
+            _writers_out.store(ticket + 1, std::memory_order_release);
+            return false;
+        }
+
+        /** release the write lock, the readers that arrived during the write phase enter first.
+         */
+        void unlock() noexcept {
+            _readers_in.fetch_and(~writer_bits, std::memory_order_release);
+            _writers_out.store(_writers_out.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /** create an unlocked lock. */
+        phase_fair_write_lock() noexcept = default;
+
+        /** not copy-assignable */
+        phase_fair_write_lock(const phase_fair_write_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const phase_fair_write_lock &) = delete;
+    };
+
+    /** A phase fair read/write lock.
+     *
+     * Read and write phases alternate: once a writer waits, new readers wait for it, and the readers that arrived during
+     * a write phase are all admitted before the next writer. Neither readers nor writers starve, a reader waits for at most
+     * one writer and a writer for at most one read phase (and the writers ahead of it).
+     *
+     * Waiting threads busy wait, then yield the CPU: this lock is meant for short critical sections. It's used like
+     * read_write_lock.
+     *
+     * <pre><code>
+     * pthread::phase_fair_read_write_lock rwlock;
+     *
+     * {
+     *   pthread::lock_guard<pthread::phase_fair_read_lock> lock(rwlock);
+     *   ...
+     * }
+     *
+     * {
+     *   pthread::lock_guard<pthread::phase_fair_write_lock> lock(rwlock);
+     *   ...
+     * }
+     * </code></pre>
+     *
+     * @see B. Brandenburg and J. Anderson, Spin-Based Reader-Writer Synchronization for Multiprocessor Real-Time Systems (PF-T lock).
+     */
+    typedef phase_fair_write_lock phase_fair_read_write_lock;
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_phase_fair_lock_hpp */
@@ -19,10 +19,24 @@
 #include <pthread.h>
 
 #include "pthread/mutex.hpp"
+#include "pthread/futex_mutex.hpp"
+#include "pthread/spin_lock.hpp"
+#include "pthread/aligned_memory.hpp"
+#include "pthread/mcs_lock.hpp"
+#include "pthread/lock_profile.hpp"
 #include "pthread/read_write_lock.hpp"
+#include "pthread/phase_fair_lock.hpp"
+#include "pthread/read_indicator.hpp"
+#include "pthread/big_reader_lock.hpp"
+#include "pthread/seqlock.hpp"
 #include "pthread/lock_guard.hpp"
+#include "pthread/unique_lock.hpp"
 #include "pthread/condition_variable.hpp"
+#include "pthread/upgradable_lock.hpp"
+#include "pthread/rcu.hpp"
+#include "pthread/left_right.hpp"
 #include "pthread/thread.hpp"
+#include "pthread/thread_specific.hpp"
 #include "pthread/sync_queue.hpp"
 #include "pthread/exceptions.hpp"
 
@@ -38,6 +52,18 @@ namespace pthread {
      *  @example synchronized_queue_tests.cpp
      *  @example exceptions_tests.cpp
      *  @example abstract_thread_tests.cpp
+     *  @example thread_specific_tests.cpp
+     *  @example futex_mutex_tests.cpp
+     *  @example spin_lock_tests.cpp
+     *  @example lock_profile_tests.cpp
+     *  @example unique_lock_tests.cpp
+     *  @example phase_fair_lock_tests.cpp
+     *  @example big_reader_lock_tests.cpp
+     *  @example seqlock_tests.cpp
+     *  @example upgradable_lock_tests.cpp
+     *  @example rcu_tests.cpp
+     *  @example left_right_tests.cpp
+     *  @example aligned_memory_tests.cpp
      */
 
   /** @return library version */
@@ -0,0 +1,263 @@
+//
+//  rcu.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_rcu_hpp
+#define pthread_rcu_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "pthread/exceptions.hpp"
+#include "pthread/mutex.hpp"
+#include "pthread/lock_guard.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Epoch based read-copy-update (RCU).
+     *
+     * Readers enter a read-side critical section, read shared data through rcu_pointer instances and leave. Entering and
+     * leaving only write to a slot owned by the calling thread (on its own cache line): readers never block and never
+     * write shared cache lines.
+     *
+     * Writers publish a new version of the data and retire the old one. A retired version is freed once every reader
+     * that could have seen it has left its read-side critical section (a grace period). synchronize() waits for a grace
+     * period, reclaim() frees what can be freed without waiting.
+     *
+     * On Linux, writers use the membarrier system call so that readers don't need memory fences. Elsewhere readers issue
+     * a full memory fence when they enter a read-side critical section.
+     *
+     * There is one process wide domain (see global()), it can be used with a lock_guard:
+     *
+     * <pre><code>
+     * pthread::rcu_pointer<routing_table> routes{new routing_table};
+     *
+     * { // readers
+     *   pthread::lock_guard<pthread::rcu_domain> read_side(pthread::rcu_domain::global());
+     *   auto next_hop = routes.load()->lookup(address);
+     * }
+     *
+     * routes.update(new routing_table(...)); // writer, the old table is freed after a grace period
+     * </code></pre>
+     */
+    class rcu_domain {
+    public:
+
+        /** @return the process wide domain (it's never destroyed). */
+        static rcu_domain &global();
+
+        /** enter a read-side critical section (they can be nested).
+         *
+         * The first call made by a thread registers it (this allocates a reader slot). The calling thread must not call
+         * synchronize() before it leaves the critical section.
+         */
+        void lock() noexcept {
+            reader *local = _local_reader != nullptr ? _local_reader : register_reader();
+            if (local->nesting++ == 0) {
+                local->epoch.store(_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+                if (_membarrier) {
+                    std::atomic_signal_fence(std::memory_order_seq_cst); // synchronize() makes this a full fence
+                } else {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                }
+            }
+        }
+
+        /** leave a read-side critical section, pointers read within the section must not be used anymore.
+         */
+        void unlock() noexcept {
+            reader *local = _local_reader;
+            if (--local->nesting == 0) {
+                local->epoch.store(0, std::memory_order_release);
+            }
+        }
+
+        /** @return true if the calling thread is in a read-side critical section. */
+        bool in_read_section() const noexcept {
+            return _local_reader != nullptr && _local_reader->nesting > 0;
+        }
+
+        /** wait for a grace period: readers that were in a read-side critical section have left it.
+         *
+         * @throw pthread_exception (EDEADLK) if the calling thread is in a read-side critical section.
+         */
+        void synchronize();
+
+        /** free pointer once no reader can reference it anymore.
+         *
+         * The pointer must be unreachable for new readers (i.e. replaced in its rcu_pointer). When enough pointers are
+         * waiting, the calling thread waits for a grace period and frees them (unless it's in a read-side critical section).
+         *
+         * @param pointer pointer to free.
+         * @param deleter function that frees pointer.
+         */
+        void retire(void *pointer, void (*deleter)(void *));
+
+        /** delete pointer once no reader can reference it anymore (see retire(void *, void (*)(void *))).
+         *
+         * @param pointer pointer to delete (allocated with new).
+         */
+        template<class T>
+        void retire(T *pointer) {
+            retire(pointer, [](void *retired) { delete static_cast<T *>(retired); });
+        }
+
+        /** free the retired pointers that no reader can reference anymore, doesn't wait.
+         *
+         * @return number of freed pointers.
+         */
+        std::size_t reclaim();
+
+        /** @return number of retired pointers that are not freed yet. */
+        std::size_t retired() const;
+
+        /** @return current epoch, incremented by each synchronize() and reclaim(). */
+        std::uint64_t epoch() const noexcept {
+            return _epoch.load(std::memory_order_acquire);
+        }
+
+        /** not copy-assignable */
+        rcu_domain(const rcu_domain &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const rcu_domain &) = delete;
+
+    private:
+
+        /** the read-side state of a thread. */
+        struct alignas(64) reader {
+            std::atomic<std::uint64_t> epoch; //!< epoch when the thread entered its read-side critical section, 0 outside
+            std::uint32_t nesting;            //!< nested read-side critical sections (only used by the owner thread)
+            std::atomic<bool> in_use;         //!< owned by a running thread
+            reader *next;                     //!< readers list (readers are never removed, they're reused)
+        };
+
+        static_assert(alignof(reader) == 64, "reader slots must sit on their own cache line");
+
+        /** a pointer waiting for a grace period. */
+        struct retired_pointer {
+            void *pointer;
+            void (*deleter)(void *);
+            std::uint64_t epoch; //!< epoch when the pointer was retired
+        };
+
+        rcu_domain();
+
+        /** give the calling thread a reader slot, it's released when the thread ends. */
+        reader *register_reader() noexcept;
+
+        /** make the readers' stores visible to the calling thread (and the other way round). */
+        void heavy_fence() noexcept;
+
+        /** @return the lowest epoch of the readers that are in a read-side critical section (or the current epoch). */
+        std::uint64_t oldest_reader_epoch() const noexcept;
+
+        static thread_local reader *_local_reader; //!< reader slot of the calling thread
+
+        std::atomic<std::uint64_t> _epoch;   //!< global epoch, starts at 1 (0 means "not reading")
+        std::atomic<reader *> _readers;      //!< head of the readers list
+        bool _membarrier;                    //!< writers use membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED)
+
+        mutable pthread::mutex _retired_mutex;  //!< protects _retired
+        std::vector<retired_pointer> _retired;  //!< pointers waiting for a grace period
+    };
+
+    /** A pointer to data shared with RCU readers.
+     *
+     * Readers call load() within a read-side critical section, writers replace the data with update() or modify(): the
+     * previous version is retired and freed after a grace period.
+     *
+     * @tparam T type of the shared data.
+     */
+    template<class T>
+    class rcu_pointer {
+    public:
+
+        /** @return the current version, only valid until the calling thread leaves its read-side critical section.
+         */
+        T *load() const noexcept {
+            return _pointer.load(std::memory_order_acquire);
+        }
+
+        /** publish a new version and retire the previous one.
+         *
+         * @param value new version (allocated with new), this instance owns it.
+         */
+        void update(T *value) {
+            T *previous = _pointer.exchange(value, std::memory_order_seq_cst); // ordered with the epoch recorded by retire()
+            if (previous != nullptr) {
+                _domain.retire(previous);
+            }
+        }
+
+        /** copy the current version, modify the copy and publish it (concurrent calls to modify are serialized).
+         *
+         * <pre><code>
+         * config.modify([](settings &copy) { copy["timeout"] = "30"; });
+         * </code></pre>
+         *
+         * @param modifier code that changes the copy (void modifier(T &)).
+         */
+        template<class Modifier>
+        void modify(Modifier modifier) {
+            pthread::lock_guard<pthread::mutex> lock(_writers);
+            T *current = _pointer.load(std::memory_order_relaxed);
+            T *copy = current != nullptr ? new T(*current) : new T();
+
+            CPP_PTHREAD_TRY {
+                modifier(*copy);
+            } CPP_PTHREAD_CATCH_ALL {
+                delete copy;
+                CPP_PTHREAD_RETHROW;
+            }
+
+            update(copy);
+        }
+
+        /** @return the domain readers of this pointer use. */
+        rcu_domain &domain() const noexcept {
+            return _domain;
+        }
+
+        /** create an RCU pointer.
+         *
+         * @param value initial version (allocated with new, this instance owns it).
+         * @param domain domain used to retire old versions.
+         */
+        explicit rcu_pointer(T *value = nullptr, rcu_domain &domain = rcu_domain::global()) : _pointer(value), _domain(domain) {
+        }
+
+        /** delete the current version, no reader must be using it. */
+        ~rcu_pointer() {
+            delete _pointer.load(std::memory_order_relaxed);
+        }
+
+        /** not copy-assignable */
+        rcu_pointer(const rcu_pointer &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const rcu_pointer &) = delete;
+
+    private:
+        std::atomic<T *> _pointer;
+        rcu_domain &_domain;
+        pthread::mutex _writers; //!< serializes modify()
+    };
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_rcu_hpp */
@@ -0,0 +1,91 @@
+//
+//  read_indicator.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_read_indicator_hpp
+#define pthread_read_indicator_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pthread {
+
+    namespace detail {
+
+        /** Counts the readers of a read mostly structure (see big_reader_lock and left_right).
+         *
+         * Readers are spread over one slot per CPU (threads are assigned slots in a round robin way), each slot sits on its
+         * own cache line: readers running on different CPUs don't bounce a shared cache line. A writer pays for it, it
+         * scans every slot to know if readers are left.
+         */
+        class read_indicator {
+        public:
+
+            /** reader counter of a subset of the threads. */
+            struct alignas(64) slot {
+                std::atomic<std::uint32_t> readers; //!< readers that arrived through this slot and didn't depart yet
+            };
+
+            /** @return the slot of the calling thread. */
+            slot &local_slot() noexcept {
+                static thread_local std::size_t index = next_index();
+                return _slots[index & _mask];
+            }
+
+            /** a reader arrives, it increments its own slot. */
+            void arrive() noexcept {
+                local_slot().readers.fetch_add(1, std::memory_order_seq_cst);
+            }
+
+            /** a reader (the thread that arrived) departs. */
+            void depart() noexcept {
+                local_slot().readers.fetch_sub(1, std::memory_order_release);
+            }
+
+            /** @return true if there's no reader. */
+            bool empty() const noexcept;
+
+            /** busy wait until the readers that arrived are gone (see util::spin_wait). */
+            void wait_until_empty() const noexcept;
+
+            /** @return number of slots (the number of CPUs rounded up to a power of 2, 1024 at most). */
+            std::size_t slots() const noexcept {
+                return _mask + 1;
+            }
+
+            /** allocate one slot per CPU, on cache line boundaries.
+             *
+             * @throw pthread_exception if the slots can't be allocated.
+             */
+            read_indicator();
+
+            /** release the slots. */
+            ~read_indicator();
+
+            /** not copy-assignable */
+            read_indicator(const read_indicator &) = delete;
+
+            /** not copy-assignable */
+            void operator=(const read_indicator &) = delete;
+
+        private:
+
+            /** @return a thread index (incremented for each new thread). */
+            static std::size_t next_index() noexcept;
+
+            slot *_slots;      //!< one reader counter per CPU
+            std::size_t _mask; //!< slots count - 1
+        };
+
+        static_assert(alignof(read_indicator::slot) == 64, "reader slots must sit on their own cache line");
+    }
+
+} // namespace pthread
+
+#endif /* pthread_read_indicator_hpp */
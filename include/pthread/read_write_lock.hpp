@@ -13,7 +13,11 @@
 // recommandation for more info p.285 §8.3.1).
 #include <pthread.h>
 
+#include <chrono>
+#include <string>
+
 #include "pthread/exceptions.hpp"
+#include "pthread/mutex.hpp"
 
 
 namespace pthread {
@@ -24,6 +28,17 @@ namespace pthread {
      */
 
 
+    /** Which of readers or writers get the lock first when both are waiting.
+     *
+     * On glibc, the default policy (NULL attributes) prefers readers: as long as readers overlap, a writer waits, possibly
+     * forever.
+     *
+     * @see pthread_rwlockattr_setkind_np
+     */
+    enum class rwlock_policy {
+        prefer_readers, //!< readers get the lock even if writers are waiting (PTHREAD_RWLOCK_PREFER_READER_NP)
+        prefer_writers  //!< new readers wait while a writer is waiting (PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP), a thread must not take a read lock it already holds
+    };
 
     /** This class acquires the read lock.
      *
@@ -33,6 +48,7 @@ namespace pthread {
      * @author herbert koelman (herbert.koelman@me.com)
      * @since v1.6.0
      * @see pthread::read_write_lock
+     * @see pthread::phase_fair_read_write_lock
      */
     class read_lock {
     public:
@@ -44,23 +60,105 @@ namespace pthread {
          */
         void lock();
 
-        /** The method shall apply a read lock, if any thread currently holds the lock (for reading or writing)
-         * the method throws an exception.
+        /** apply a read lock, errors are reported in ec instead of being thrown.
          *
+         * @param ec error returned by pthread_rwlock_rdlock, cleared on success.
+         */
+        void lock(std::error_code &ec) noexcept;
+
+        /** The method shall apply a read lock, it doesn't block if a writer holds the lock.
+         *
+         * @return true if the read lock was acquired, false if a writer holds the lock.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed (a busy lock is not an error).
          @see lock
          */
-        void try_lock();
+        bool try_lock();
+
+        /** try to apply a read lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_tryrdlock (EBUSY is not an error), cleared on success.
+         * @return true if the read lock was acquired, false if a writer holds the lock or on error.
+         */
+        bool try_lock(std::error_code &ec) noexcept;
+
+        /** Try to apply a read lock, block at most millis milliseconds.
+         *
+         * @param millis milliseconds to wait for the lock.
+         * @return true if the read lock was acquired, false if the time out expired.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         * @see try_lock_until
+         */
+        bool try_lock_for(int millis);
+
+        /** Same as try_lock_for(int), errors are reported in ec instead of being thrown.
+         *
+         * @param millis milliseconds to wait for the lock.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the read lock was acquired, false if the time out expired or on error.
+         */
+        bool try_lock_for(int millis, std::error_code &ec) noexcept;
+
+        /** Try to apply a read lock, block until deadline is reached.
+         *
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @return true if the read lock was acquired, false if the deadline was reached.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         * @see pthread_rwlock_clockrdlock
+         * @see pthread_rwlock_timedrdlock
+         */
+        bool try_lock_until(std::chrono::steady_clock::time_point deadline);
+
+        /** Same as try_lock_until(std::chrono::steady_clock::time_point), errors are reported in ec instead of being thrown.
+         *
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the read lock was acquired, false if the deadline was reached or on error.
+         */
+        bool try_lock_until(std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept;
+
+        /** Try to apply a read lock, block at most for the given duration (i.e. std::chrono::microseconds(200)).
+         *
+         * @param duration time to wait for the lock.
+         * @return true if the read lock was acquired, false if the time out expired.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        template<class Rep, class Period>
+        bool try_lock_for(const std::chrono::duration<Rep, Period> &duration) {
+            return try_lock_until(detail::steady_deadline(duration));
+        }
+
+        /** Same as try_lock_for(const std::chrono::duration<Rep, Period> &), errors are reported in ec instead of being thrown.
+         *
+         * @param duration time to wait for the lock.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the read lock was acquired, false if the time out expired or on error.
+         */
+        template<class Rep, class Period>
+        bool try_lock_for(const std::chrono::duration<Rep, Period> &duration, std::error_code &ec) noexcept {
+            return try_lock_until(detail::steady_deadline(duration), ec);
+        }
+
+        /** Try to apply a read lock, block until deadline (of any clock) is reached.
+         *
+         * @param deadline point in time after which the calling thread gives up.
+         * @return true if the read lock was acquired, false if the deadline was reached.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        template<class Clock, class Duration>
+        bool try_lock_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+            return try_lock_until(detail::steady_deadline(deadline));
+        }
 
         /** release the read lock.
          @throw read_write_lock_exception if error conditions preventing this method to succeed.
          */
         void unlock();
 
-
-        /**
-         * the descructor, shall destroy the read-write lock object referenced by rwlock and release any resources used by the lock.
+        /** release the lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_unlock, cleared on success.
          */
-        virtual ~read_lock();
+        void unlock(std::error_code &ec) noexcept;
 
         /** not copy-assignable
          *
@@ -84,6 +182,36 @@ namespace pthread {
          */
         read_lock();
 
+        /** create a read/write lock that follows the given policy.
+
+         @param policy prefer readers or writers.
+         @throw read_write_lock_exception if error conditions preventing this method to succeed (ENOTSUP if the platform doesn't support policies).
+         */
+        explicit read_lock(rwlock_policy policy);
+
+        /**
+         * the descructor, shall destroy the read-write lock object referenced by rwlock and release any resources used by the lock.
+         *
+         * The destructor is not virtual (read_lock has no vtable), it's protected so that a write_lock (read_write_lock)
+         * can't be deleted through a pointer to read_lock.
+         */
+        ~read_lock();
+
+        /** wait for the lock until deadline is reached.
+         *
+         * @param exclusive true to acquire the write lock.
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @return 0 if the lock was acquired, ETIMEDOUT or an error code.
+         */
+        int timed_lock(bool exclusive, std::chrono::steady_clock::time_point deadline) noexcept;
+
+        /** throw a read_write_lock_exception (cold path).
+         *
+         * @param message short description.
+         * @param ret error returned by the pthread function.
+         */
+        [[noreturn]] static void failed(const char *message, int ret);
+
         pthread_rwlock_t _rwlock; //!< NOSONAR read/write lock reference union is declared in the POSIX Threading library. It cannot be changed (ignoring rule MISRA C++:2008, 9-5-1 - Unions shall not be used.)
     };
 
@@ -92,7 +220,7 @@ namespace pthread {
      * @author herbert koelman (herbert.koelman@me.com)
      * @since v1.6.0
      */
-    class write_lock : public read_lock {
+    class write_lock final : public read_lock {
     public:
         /** The method apply a write lock.
          *
@@ -101,12 +229,94 @@ namespace pthread {
          */
         void lock();
 
-        /** The method shall apply a write lock, if any thread currently holds the lock (for reading or writing)
-         * the method throws an exception.
+        /** apply a write lock, errors are reported in ec instead of being thrown.
          *
+         * @param ec error returned by pthread_rwlock_wrlock, cleared on success.
+         */
+        void lock(std::error_code &ec) noexcept;
+
+        /** The method shall apply a write lock, it doesn't block if any thread currently holds the lock (for reading or writing).
+         *
+         * @return true if the write lock was acquired, false if the lock is held.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed (a busy lock is not an error).
          @see lock
          */
-        void try_lock();
+        bool try_lock();
+
+        /** try to apply a write lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_rwlock_trywrlock (EBUSY is not an error), cleared on success.
+         * @return true if the write lock was acquired, false if the lock is held or on error.
+         */
+        bool try_lock(std::error_code &ec) noexcept;
+
+        /** Try to apply a write lock, block at most millis milliseconds.
+         *
+         * @param millis milliseconds to wait for the lock.
+         * @return true if the write lock was acquired, false if the time out expired.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         * @see try_lock_until
+         */
+        bool try_lock_for(int millis);
+
+        /** Same as try_lock_for(int), errors are reported in ec instead of being thrown.
+         *
+         * @param millis milliseconds to wait for the lock.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the write lock was acquired, false if the time out expired or on error.
+         */
+        bool try_lock_for(int millis, std::error_code &ec) noexcept;
+
+        /** Try to apply a write lock, block until deadline is reached.
+         *
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @return true if the write lock was acquired, false if the deadline was reached.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         * @see pthread_rwlock_clockwrlock
+         * @see pthread_rwlock_timedwrlock
+         */
+        bool try_lock_until(std::chrono::steady_clock::time_point deadline);
+
+        /** Same as try_lock_until(std::chrono::steady_clock::time_point), errors are reported in ec instead of being thrown.
+         *
+         * @param deadline point in time (steady clock) after which the calling thread gives up.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the write lock was acquired, false if the deadline was reached or on error.
+         */
+        bool try_lock_until(std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept;
+
+        /** Try to apply a write lock, block at most for the given duration (i.e. std::chrono::microseconds(200)).
+         *
+         * @param duration time to wait for the lock.
+         * @return true if the write lock was acquired, false if the time out expired.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        template<class Rep, class Period>
+        bool try_lock_for(const std::chrono::duration<Rep, Period> &duration) {
+            return try_lock_until(detail::steady_deadline(duration));
+        }
+
+        /** Same as try_lock_for(const std::chrono::duration<Rep, Period> &), errors are reported in ec instead of being thrown.
+         *
+         * @param duration time to wait for the lock.
+         * @param ec error returned by pthread (ETIMEDOUT is not an error), cleared on success.
+         * @return true if the write lock was acquired, false if the time out expired or on error.
+         */
+        template<class Rep, class Period>
+        bool try_lock_for(const std::chrono::duration<Rep, Period> &duration, std::error_code &ec) noexcept {
+            return try_lock_until(detail::steady_deadline(duration), ec);
+        }
+
+        /** Try to apply a write lock, block until deadline (of any clock) is reached.
+         *
+         * @param deadline point in time after which the calling thread gives up.
+         * @return true if the write lock was acquired, false if the deadline was reached.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed.
+         */
+        template<class Clock, class Duration>
+        bool try_lock_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+            return try_lock_until(detail::steady_deadline(deadline));
+        }
 
         /**
          Constructor/Desctructor
@@ -118,6 +328,17 @@ namespace pthread {
          */
         write_lock();
 
+        /** create a read/write lock that prefers either readers or writers.
+         *
+         * <pre><code>
+         * pthread::read_write_lock config_lock{pthread::rwlock_policy::prefer_writers}; // readers don't starve writers
+         * </code></pre>
+         *
+         * @param policy prefer readers or writers.
+         * @throw read_write_lock_exception if error conditions preventing this method to succeed (ENOTSUP if the platform doesn't support policies).
+         */
+        explicit write_lock(rwlock_policy policy);
+
         /** not copy-assignable
          *
          */
@@ -126,7 +347,7 @@ namespace pthread {
         /**
          * the descructor, shall destroy the read-write lock object referenced by rwlock and release any resources used by the lock.
          */
-        virtual ~write_lock();
+        ~write_lock();
 
         void operator=(const write_lock &) = delete;
 
@@ -156,6 +377,44 @@ namespace pthread {
      */
     typedef write_lock read_write_lock;
 
+    // inline implementation ----------------------
+    //
+    // lock and unlock are inlined, so that an uncontended lock_guard costs no more than the pthread calls. Error handling
+    // is done out of line.
+
+    inline void read_lock::lock() {
+        int ret = pthread_rwlock_rdlock(&_rwlock);
+        if (ret != 0) {
+            failed("Try get read lock failed.", ret);
+        }
+    }
+
+    inline void read_lock::lock(std::error_code &ec) noexcept {
+        ec.assign(pthread_rwlock_rdlock(&_rwlock), std::system_category());
+    }
+
+    inline void read_lock::unlock() {
+        int ret = pthread_rwlock_unlock(&_rwlock);
+        if (ret != 0) {
+            failed("failed to unlock read/read lock.", ret);
+        }
+    }
+
+    inline void read_lock::unlock(std::error_code &ec) noexcept {
+        ec.assign(pthread_rwlock_unlock(&_rwlock), std::system_category());
+    }
+
+    inline void write_lock::lock() {
+        int ret = pthread_rwlock_wrlock(&_rwlock);
+        if (ret != 0) {
+            failed("Try get write lock failed.", ret);
+        }
+    }
+
+    inline void write_lock::lock(std::error_code &ec) noexcept {
+        ec.assign(pthread_rwlock_wrlock(&_rwlock), std::system_category());
+    }
+
     /** @} */
 } // namespace pthread
 
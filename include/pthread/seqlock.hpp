@@ -0,0 +1,192 @@
+//
+//  seqlock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_seqlock_hpp
+#define pthread_seqlock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "pthread/exceptions.hpp"
+#include "pthread/spin_lock.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Sequence lock, holds a small value that is read very often and seldom written.
+     *
+     * Writers make the sequence number odd, update the value and make the sequence number even again. Readers don't write
+     * to shared memory: they read the sequence number, copy the value and check that the sequence number didn't change
+     * (they retry otherwise). Readers never block writers, and a reader never sees a half written (torn) value.
+     *
+     * The value is copied word by word with relaxed atomic loads and stores, so concurrent copies are not data races.
+     *
+     * <pre><code>
+     * struct quote { long bid; long ask; };
+     * pthread::seqlock<quote> latest{quote{0, 0}};
+     *
+     * latest.store(quote{101, 102}); // writer
+     * quote current = latest.load(); // readers
+     * </code></pre>
+     *
+     * @tparam T a trivially copyable and default constructible type (a few machine words at most, readers copy the whole
+     *         value on each try).
+     */
+    template<class T>
+    class seqlock {
+        static_assert(std::is_trivially_copyable<T>::value, "seqlock values must be trivially copyable");
+
+    public:
+
+        /** @return a consistent copy of the value (retries while a writer is updating it).
+         */
+        T load() const noexcept {
+            T value;
+            util::backoff backoff;
+            while (!try_load(value)) {
+                backoff.pause();
+            }
+            return value;
+        }
+
+        /** copy the value once.
+         *
+         * @param value receives the copy, its content is meaningless if false is returned.
+         * @return true if the copy is consistent, false if a writer updated the value meanwhile.
+         */
+        bool try_load(T &value) const noexcept {
+            const std::uint32_t before = _sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0) {
+                return false; // a write is in progress
+            }
+
+            word copy[words];
+            for (std::size_t index = 0; index < words; index++) {
+                copy[index] = _value[index].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_sequence.load(std::memory_order_relaxed) != before) {
+                return false;
+            }
+
+            std::memcpy(&value, copy, sizeof(T));
+            return true;
+        }
+
+        /** replace the value (writers are serialized).
+         *
+         * @param value new value.
+         */
+        void store(const T &value) noexcept {
+            word copy[words] = {};
+            std::memcpy(copy, &value, sizeof(T));
+
+            const std::uint32_t sequence = begin_write();
+            for (std::size_t index = 0; index < words; index++) {
+                _value[index].store(copy[index], std::memory_order_relaxed);
+            }
+            _sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /** read, modify and write the value, other writers wait.
+         *
+         * <pre><code>
+         * counters.update([](stats &value) { value.hits++; });
+         * </code></pre>
+         *
+         * @param modifier code that changes the value (void modifier(T &)), it must not call this seqlock's writer methods.
+         */
+        template<class Modifier>
+        void update(Modifier modifier) {
+            const std::uint32_t sequence = begin_write();
+
+            word copy[words];
+            for (std::size_t index = 0; index < words; index++) {
+                copy[index] = _value[index].load(std::memory_order_relaxed);
+            }
+
+            T value;
+            std::memcpy(&value, copy, sizeof(T));
+            CPP_PTHREAD_TRY {
+                modifier(value);
+            } CPP_PTHREAD_CATCH_ALL {
+                _sequence.store(sequence + 2, std::memory_order_release); // value unchanged
+                CPP_PTHREAD_RETHROW;
+            }
+            std::memcpy(copy, &value, sizeof(T));
+
+            for (std::size_t index = 0; index < words; index++) {
+                _value[index].store(copy[index], std::memory_order_relaxed);
+            }
+            _sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /** @return the sequence number, it's incremented twice by each write (odd while a write is in progress).
+         */
+        std::uint32_t sequence() const noexcept {
+            return _sequence.load(std::memory_order_acquire);
+        }
+
+        /** create a sequence lock.
+         *
+         * @param value initial value.
+         */
+        explicit seqlock(const T &value = T()) noexcept: _sequence(0) {
+            word copy[words] = {};
+            std::memcpy(copy, &value, sizeof(T));
+            for (std::size_t index = 0; index < words; index++) {
+                _value[index].store(copy[index], std::memory_order_relaxed);
+            }
+        }
+
+        /** not copy-assignable */
+        seqlock(const seqlock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const seqlock &) = delete;
+
+    private:
+
+        typedef std::uintptr_t word;
+
+        static const std::size_t words = (sizeof(T) + sizeof(word) - 1) / sizeof(word); //!< value size in words
+
+        /** wait for an even sequence number and make it odd.
+         *
+         * @return the (even) sequence number before the write.
+         */
+        std::uint32_t begin_write() noexcept {
+            std::uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+            util::backoff backoff;
+            while ((sequence & 1) != 0 || !_sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                backoff.pause();
+                sequence = _sequence.load(std::memory_order_relaxed);
+            }
+
+            // readers that see the new value must see the odd sequence number first
+            std::atomic_thread_fence(std::memory_order_release);
+            return sequence;
+        }
+
+        std::atomic<std::uint32_t> _sequence; //!< even when the value is stable, odd while a writer updates it
+        std::atomic<word> _value[words];      //!< the value, copied word by word
+    };
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_seqlock_hpp */
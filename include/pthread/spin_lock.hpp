@@ -0,0 +1,273 @@
+//
+//  spin_lock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_spin_lock_hpp
+#define pthread_spin_lock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "pthread/exceptions.hpp"
+
+namespace pthread {
+
+    namespace util {
+
+        /** \addtogroup util
+         *
+         * @{
+         */
+
+        /** Tell the CPU that the calling thread is busy waiting (pause instruction).
+         *
+         * This lowers the power consumed by spinning threads and frees resources for the sibling hyper-thread.
+         */
+        inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__powerpc__) || defined(__ppc__) || defined(_ARCH_PPC)
+            __asm__ __volatile__("or 27,27,27" ::: "memory");
+#else
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+        }
+
+        /** Exponential back off of a busy waiting thread.
+         *
+         * Each pause() calls cpu_relax() twice as many times as the previous one. Once max_spins is reached, pause() yields
+         * the CPU instead: the thread that is waited for may have been preempted.
+         *
+         * <pre><code>
+         * pthread::util::backoff backoff;
+         * while (!done.load(std::memory_order_acquire)) {
+         *   backoff.pause();
+         * }
+         * </code></pre>
+         */
+        class backoff {
+        public:
+
+            static const std::uint32_t max_spins = 1024; //!< cpu_relax() calls before yielding the CPU
+
+            /** wait a bit longer than the previous time. */
+            void pause() noexcept {
+                if (_spins < max_spins) {
+                    for (std::uint32_t count = _spins; count > 0; count--) {
+                        cpu_relax();
+                    }
+                    _spins <<= 1;
+                } else {
+                    sched_yield();
+                }
+            }
+
+            /** start over with a short pause. */
+            void reset() noexcept {
+                _spins = 1;
+            }
+
+            backoff() noexcept: _spins(1) {
+            }
+
+        private:
+            std::uint32_t _spins; //!< cpu_relax() calls of the next pause
+        };
+
+        /** busy wait (see backoff) until done returns true.
+         *
+         * @param done predicate checked before each pause.
+         */
+        template<class Predicate>
+        void spin_wait(Predicate done) noexcept(noexcept(done())) {
+            backoff backoff;
+            while (!done()) {
+                backoff.pause();
+            }
+        }
+
+        /** @} */
+    } // namespace util
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+#if defined(_POSIX_SPIN_LOCKS) && _POSIX_SPIN_LOCKS > 0
+
+    /** POSIX spin lock.
+     *
+     * A thread that can't get the lock busy waits instead of sleeping. This is cheaper than a mutex for critical sections
+     * of a few dozen nanoseconds (counters updates, pointer swaps, ...), but burns CPU if the lock is held for long or if
+     * the owner is preempted.
+     *
+     * <pre><code>
+     * pthread::spin_lock lock;
+     * {
+     *   pthread::lock_guard<pthread::spin_lock> guard(lock);
+     *   ...
+     * }
+     * </code></pre>
+     *
+     * @see pthread_spin_lock
+     */
+    class spin_lock {
+    public:
+
+        /** spin until the lock is acquired.
+         *
+         * @throw mutex_exception if the lock cannot be acquired (EDEADLK, ...).
+         */
+        void lock() {
+            int rc = pthread_spin_lock(&_spin_lock);
+            if (rc != 0) {
+                throw_exception(mutex_exception("pthread_spin_lock failed.", rc));
+            }
+        }
+
+        /** spin until the lock is acquired, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_spin_lock, cleared on success.
+         */
+        void lock(std::error_code &ec) noexcept {
+            ec.assign(pthread_spin_lock(&_spin_lock), std::system_category());
+        }
+
+        /** @return true if the lock was acquired, false if it's held by some thread.
+         *
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock() {
+            int rc = pthread_spin_trylock(&_spin_lock);
+            if (rc != 0 && rc != EBUSY) {
+                throw_exception(mutex_exception("pthread_spin_trylock failed.", rc));
+            }
+            return rc == 0;
+        }
+
+        /** @return true if the lock was acquired, false if it's held by some thread or on error.
+         *
+         * @param ec error returned by pthread_spin_trylock (EBUSY is not an error), cleared on success.
+         */
+        bool try_lock(std::error_code &ec) noexcept {
+            int rc = pthread_spin_trylock(&_spin_lock);
+            ec.assign(rc == EBUSY ? 0 : rc, std::system_category());
+            return rc == 0;
+        }
+
+        /** release the lock.
+         *
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        void unlock() {
+            int rc = pthread_spin_unlock(&_spin_lock);
+            if (rc != 0) {
+                throw_exception(mutex_exception("pthread_spin_unlock failed.", rc));
+            }
+        }
+
+        /** release the lock, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error returned by pthread_spin_unlock, cleared on success.
+         */
+        void unlock(std::error_code &ec) noexcept {
+            ec.assign(pthread_spin_unlock(&_spin_lock), std::system_category());
+        }
+
+        /** initialize an unlocked (process private) spin lock.
+         *
+         * @throw mutex_exception if pthread_spin_init failed.
+         */
+        spin_lock() {
+            int rc = pthread_spin_init(&_spin_lock, PTHREAD_PROCESS_PRIVATE);
+            if (rc != 0) {
+                throw_exception(mutex_exception("pthread_spin_init failed.", rc));
+            }
+        }
+
+        /** @see pthread_spin_destroy */
+        ~spin_lock() {
+            pthread_spin_destroy(&_spin_lock);
+        }
+
+        /** not copy-assignable */
+        spin_lock(const spin_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const spin_lock &) = delete;
+
+    private:
+        pthread_spinlock_t _spin_lock;
+    };
+
+#endif
+
+    /** Fair spin lock.
+     *
+     * Threads are granted the lock in the order they asked for it (first come, first served), like customers taking a
+     * ticket at a counter. A waiting thread backs off exponentially between two checks of the ticket being served, and
+     * yields the CPU once the back off limit is reached (this bounds the cost of a preempted lock owner).
+     *
+     * <pre><code>
+     * pthread::ticket_lock lock;
+     * {
+     *   pthread::lock_guard<pthread::ticket_lock> guard(lock);
+     *   ...
+     * }
+     * </code></pre>
+     */
+    class ticket_lock {
+    public:
+
+        /** take a ticket and wait for it to be served.
+         */
+        void lock() noexcept {
+            const std::uint32_t ticket = _next.fetch_add(1, std::memory_order_relaxed);
+            util::spin_wait([this, ticket] { return _serving.load(std::memory_order_acquire) == ticket; });
+        }
+
+        /** @return true if the lock was acquired, false if it's held by some thread (or threads are waiting for it).
+         */
+        bool try_lock() noexcept {
+            std::uint32_t serving = _serving.load(std::memory_order_acquire);
+            std::uint32_t next = serving;
+            return _next.compare_exchange_strong(next, serving + 1, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        /** serve the next ticket.
+         */
+        void unlock() noexcept {
+            _serving.store(_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /** create an unlocked ticket lock. */
+        ticket_lock() noexcept: _next(0), _serving(0) {
+        }
+
+        /** not copy-assignable */
+        ticket_lock(const ticket_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const ticket_lock &) = delete;
+
+    private:
+
+        std::atomic<std::uint32_t> _next;    //!< next ticket to hand out
+        std::atomic<std::uint32_t> _serving; //!< ticket that holds the lock
+    };
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_spin_lock_hpp */
@@ -10,6 +10,7 @@
 #define pthread_synchronized_queue_hpp
 
 #include <list>           // std::list
+#include <chrono>
 
 #include "pthread/pthread.hpp"
 
@@ -67,6 +68,26 @@ namespace pthread {
              */
             void put(const T &item, int wait_time);
 
+            /** Put an item in the queue, if the queue is full then wait at most wait_time for some space.
+             *
+             * @param item item to store in the queue
+             * @param wait_time time to wait for the queue to make some space for the new item (i.e. std::chrono::microseconds(100)).
+             * @throw queue_full an exception is thrown when the waiting time has expired and the queue is still full.
+             */
+            template<class Rep, class Period>
+            void put(const T &item, const std::chrono::duration<Rep, Period> &wait_time) {
+                put_until(item, pthread::detail::steady_deadline(wait_time));
+            }
+
+            /** Put an item in the queue, if the queue is full then wait until deadline for some space.
+             *
+             * @param item item to store in the queue
+             * @param deadline when to stop waiting (any clock).
+             * @throw queue_full an exception is thrown when the deadline was reached and the queue is still full.
+             */
+            template<class Clock, class Duration>
+            void put_until(const T &item, const std::chrono::time_point<Clock, Duration> &deadline);
+
             /** Get an item from the queue.
              *
              * If the queue is empty,  the method blocks until an item put in the queue.
@@ -85,6 +106,26 @@ namespace pthread {
              */
             void get(T &item, int wait_time);
 
+            /** Get an item from the queue, if the queue is empty then wait at most wait_time for an item.
+             *
+             * @param item item that will receive an item found onto the queue.
+             * @param wait_time duration we are willing to wait for a new item (i.e. std::chrono::microseconds(100)).
+             * @throw queue_timeout
+             */
+            template<class Rep, class Period>
+            void get(T &item, const std::chrono::duration<Rep, Period> &wait_time) {
+                get_until(item, pthread::detail::steady_deadline(wait_time));
+            }
+
+            /** Get an item from the queue, if the queue is empty then wait until deadline for an item.
+             *
+             * @param item item that will receive an item found onto the queue.
+             * @param deadline when to stop waiting (any clock).
+             * @throw queue_timeout
+             */
+            template<class Clock, class Duration>
+            void get_until(T &item, const std::chrono::time_point<Clock, Duration> &deadline);
+
             /** @return true if queue is empty */
             bool empty() const {
                 return _items.empty();
@@ -129,10 +170,10 @@ namespace pthread {
                     _max_size = max_size;
                 } else {
 #if __cplusplus < 201103L
-                    throw queue_exception("synchronized_queue's max size must be greater then 0.");
+                    throw_exception(queue_exception("synchronized_queue's max size must be greater then 0."));
 #else
-                    throw queue_exception("synchronized_queue's max size must be greater then 0, max_size " + std::to_string(max_size) +
-                                          " is not.");
+                    throw_exception(queue_exception("synchronized_queue's max size must be greater then 0, max_size " + std::to_string(max_size) +
+                                          " is not."));
 #endif
                 }
             }
@@ -187,19 +228,17 @@ namespace pthread {
 
         template<typename T>
         void sync_queue<T>::get(T &item, int wait_time) {
+            get(item, std::chrono::milliseconds(wait_time));
+        }
+
+        template<typename T>
+        template<class Clock, class Duration>
+        void sync_queue<T>::get_until(T &item, const std::chrono::time_point<Clock, Duration> &deadline) {
 
             pthread::lock_guard<pthread::mutex> lck(_mutex);
 
-#if __cplusplus < 201103L
-            bool not_empty = true;
-            auto delay = wait_time;
-            while ( ! (not_empty = !_items.empty()) && (_not_empty_cv.wait_for(_mutex, delay) == pthread::cv_status::no_timeout)){
-              delay = -1 ;
-            }
-#else
-            bool not_empty = _not_empty_cv.wait_for(lck, wait_time,
-                                                    [this] { return !_items.empty(); }); // keep waiting if item list is full
-#endif
+            bool not_empty = _not_empty_cv.wait_until(lck, deadline,
+                                                      [this] { return !_items.empty(); }); // keep waiting if item list is empty
 
             if (not_empty) {
                 item = _items.front();
@@ -207,7 +246,7 @@ namespace pthread {
                 _not_full_cv.notify_one();
             } else {
                 _not_full_cv.notify_all();
-                throw queue_timeout("synchronized_queue::get() timed out.");
+                throw_exception(queue_timeout("synchronized_queue::get() timed out."));
             }
         }
 
@@ -230,26 +269,23 @@ namespace pthread {
 
         template<typename T>
         void sync_queue<T>::put(const T &item, int wait_time) {
+            put(item, std::chrono::milliseconds(wait_time));
+        }
+
+        template<typename T>
+        template<class Clock, class Duration>
+        void sync_queue<T>::put_until(const T &item, const std::chrono::time_point<Clock, Duration> &deadline) {
 
             pthread::lock_guard<pthread::mutex> lck(_mutex);
 
-#if __cplusplus < 201103L
-            bool not_full = true;
-            auto delay = wait_time;
-            while ( ! (not_full = (_items.size() < _max_size)) && (_not_full_cv.wait_for(_mutex, delay) == pthread::cv_status::no_timeout)){
-              delay = -1 ;
-            }
-#else
-            // The following method signature uses lambda which is not supported by AIX XL C/C++ 13.1.2
-            bool not_full = _not_full_cv.wait_for(lck, wait_time, [this] { return _items.size() < _max_size; });
-#endif
+            bool not_full = _not_full_cv.wait_until(lck, deadline, [this] { return _items.size() < _max_size; });
 
             if (not_full) {
                 _items.push_back(item);
                 _not_empty_cv.notify_one();
             } else {
                 _not_empty_cv.notify_all();
-                throw queue_full("synchronized_queue::put() timeout, queue is full.");
+                throw_exception(queue_full("synchronized_queue::put() timeout, queue is full."));
             }
         }
 
@@ -12,17 +12,21 @@
 // WARN pthread.h must be include as first hearder file of each source code file (see IBM's
 // recommandation for more info p.285 chapter 8.3.1).
 #include <pthread.h>
+#include <sched.h>
 
 #include <iostream>
 #include <string>
 #include <functional>
 #include <memory> // std::auto_ptr, std::unique_ptr
 #include <list>
+#include <vector>
+#include <chrono>
 #include <cstddef>
 
 #include "pthread/exceptions.hpp"
 #include "pthread/mutex.hpp"
 #include "pthread/lock_guard.hpp"
+#include "pthread/spin_lock.hpp"
 
 
 namespace pthread {
@@ -47,6 +51,30 @@ namespace pthread {
      */
     extern "C" void *thread_startup_runnable(void *runner);
 
+    /** state shared by a thread instance and the thread it is running (see thread.cpp).
+     */
+    struct thread_context;
+
+    /** state shared by a thread_group and the threads it started (see thread.cpp).
+     */
+    struct thread_group_context;
+
+    class abstract_thread;
+    class thread_group;
+
+    /** resources consumed by a thread.
+     *
+     * A cpu_time close to wall_time denotes a CPU bound thread, whereas a thread that spends its time waiting for locks
+     * shows a low cpu_time and a high number of voluntary context switches.
+     */
+    struct thread_accounting {
+        std::string name;                   //!< thread name (empty if the thread was not named)
+        std::chrono::nanoseconds cpu_time;  //!< CPU time (user + system) consumed by the thread
+        std::chrono::nanoseconds wall_time; //!< time elapsed since the thread started (or until it ended)
+        long voluntary_context_switches;    //!< number of times the thread gave up the CPU (waiting on a lock, I/O, ...)
+        long involuntary_context_switches;  //!< number of times the thread was preempted
+    };
+
     /** current status of a thread instance
     */
     enum class thread_status {
@@ -92,6 +120,9 @@ namespace pthread {
      * @author herbert koelman (herbert.koelman@me.com)
      */
     class thread {
+
+        friend class abstract_thread;
+
     public:
 
         /** create a new thread.
@@ -131,6 +162,19 @@ namespace pthread {
          */
         thread(const runnable *runner, std::size_t stack_size = 0);
 
+        /** Initializes needed structures and start running a named thread.
+         *
+         * The name is applied by the new thread itself (pthread_setname_np) before the runnable is run. It shows up in tools
+         * like `top -H`, `ps -L`, perf or gdb. On Linux, names are truncated to 15 characters.
+         *
+         * @param runner a class that implements the runnable interface.
+         * @param name thread name.
+         * @param stack_size thread stack size in bytes (default is 0 and means use default stack size)
+         * @throws thread_exception is thrown if a call to pthread_attr_setstacksize, pthread_attr_setdetachstate or pthread_create fails.
+         * @see thread(const runnable *, std::size_t)
+         */
+        thread(const runnable *runner, const std::string &name, std::size_t stack_size = 0);
+
         /** Move constructor.
          *
          * once moved the given thread is not a thread anymore (status is thread_status::not_a_thread)
@@ -160,6 +204,32 @@ namespace pthread {
          */
         void join();
 
+        /** Same as join(), errors are reported in ec instead of being thrown.
+         *
+         * @param ec set to EDEADLK if thread_id == this_thread::get_id(), EINVAL if this is not a thread or to the error
+         *        returned by pthread_join. Cleared on success.
+         */
+        void join(std::error_code &ec) noexcept;
+
+        /** Join the thread if it has already ended, never blocks.
+         *
+         * @return true if the thread was joined (or if there was no thread to join), false if the thread is still running.
+         * @throws thread_exception if thread_id == this_thread::get_id() or if pthread_join fails.
+         * @see join
+         */
+        bool try_join();
+
+        /** Wait, at most the given time, for the thread to end and join it.
+         *
+         * This bounds the time a supervisor can wait for a stuck thread.
+         *
+         * @param millis milliseconds to wait for the thread to end.
+         * @return true if the thread was joined (or if there was no thread to join), false if the timeout expired.
+         * @throws thread_exception if thread_id == this_thread::get_id() or if pthread_join fails.
+         * @see join
+         */
+        bool join_for(int millis);
+
         /** A thread is considered joinable, if it has been allocated (`pthread_create`)
          *
          * @return true if this thread can be joined.
@@ -179,12 +249,55 @@ namespace pthread {
             return _status;
         };
 
+        /** @return the thread's name (empty if the thread was not named).
+         */
+        std::string name() const;
+
+        /** CPU time, context switches and wall time consumed by this thread.
+         *
+         * While the thread is running the figures are read from the system (pthread_getcpuclockid, /proc on Linux),
+         * once it has ended the method returns what was consumed when the thread exited.
+         *
+         * > *WARN* context switches are only available on Linux.
+         *
+         * @return thread's accounting (all figures are 0 if this is not a thread).
+         * @throws thread_exception if the thread's CPU clock cannot be read.
+         */
+        thread_accounting accounting() const;
+
         /** thread's current stack size (pthread_attr_getstacksize).
          *
          * @return the stack size in bytes.
          */
         size_t stack_size();
 
+        /** peak stack usage of this thread.
+         *
+         * The value is only available if stack usage measurement was enabled when the thread was started (see
+         * measure_stack_usage(bool)). Once the thread has ended, the method returns the value measured when the
+         * thread exited. While the thread is running, the painted stack is scanned on demand.
+         *
+         * @return the highest number of stack bytes used by the thread, 0 (zero) if the stack was not measured.
+         */
+        std::size_t stack_usage() const;
+
+        /** Enable or disable stack usage measurement for threads started from now on.
+         *
+         * When enabled, each new thread paints its unused stack with a known pattern before running the runnable. The
+         * stack is then scanned to find the deepest byte that was overwritten (high-water mark). Painting touches every
+         * page of the stack, so this is meant to be used to size stacks (test, staging) and not in production.
+         *
+         * > *WARN* measurement is only supported on Linux, elsewhere stack_usage() always returns 0.
+         *
+         * @param enabled true to paint the stacks of the threads that will be created.
+         * @see stack_usage
+         */
+        static void measure_stack_usage(bool enabled);
+
+        /** @return true if the stacks of newly created threads are painted and measured.
+         */
+        static bool measure_stack_usage();
+
         /** copy operator is flagged deleted,  copying doesn't make sense
          */
         thread &operator=(const thread &) = delete;
@@ -213,16 +326,28 @@ namespace pthread {
          *  If all the setup was successfull, the thread is created and started.
          * @param runner
          * @param stack_size
+         * @param name thread name (empty means unnamed)
+         * @param group group to notify when the thread ends (the thread waits for the group's go ahead before running)
          * @return 0 (zero) or an error code returned by a call to a pthread function.
          * @throws thread_exception is thrown if a call to pthread_attr_setstacksize, pthread_attr_setdetachstate or pthread_create fails.
          * @see thread_startup_runnable
          */
-        int init(const runnable *runner, std::size_t stack_size = 0);
+        int init(const runnable *runner, std::size_t stack_size = 0, const std::string &name = "",
+                 const std::shared_ptr<thread_group_context> &group = nullptr);
+
+        /** start a thread on behalf of a thread_group (which is notified when the thread ends).
+         */
+        thread(const runnable *runner, const std::string &name, std::size_t stack_size, const std::shared_ptr<thread_group_context> &group);
+
+        /** @return true if the thread has started and run to completion (it may not have been joined yet).
+         */
+        bool ended() const;
 
         pthread_t _thread; //!< thread identifier
         pthread_attr_t _attr;   //!< thread attributes (stack size, ...)
         pthread_attr_t *_attr_ptr; //!< pthread attribute pointer (null, if pthread_attr_t was not initialized) (NOSONAR)
         thread_status _status; //!< thread status (@see thread_status)
+        std::shared_ptr<thread_context> _context; //!< shared with the running thread (null if this is not a thread)
     };
 
     /** base class of a thread.
@@ -284,6 +409,9 @@ namespace pthread {
      * @author herbert koelman (herbert.koelman@me.com)
      */
     class abstract_thread : public runnable {
+
+        friend class thread_group;
+
     public:
         /**
          * setup thread base.
@@ -292,6 +420,14 @@ namespace pthread {
          */
         explicit abstract_thread(const std::size_t stack_size = 0);
 
+        /**
+         * setup a named thread base.
+         *
+         * @param name thread's name (see thread(const runnable *, const std::string &, std::size_t))
+         * @param stack_size thread's stack size (default 0 which means use PTHREAD_STACK_MIN)
+         */
+        explicit abstract_thread(const std::string &name, const std::size_t stack_size = 0);
+
         /** not copy-assignable */
         abstract_thread(const abstract_thread &) = delete;
 
@@ -309,16 +445,86 @@ namespace pthread {
          */
         void join();
 
+        /** joins this thread, errors are reported in ec instead of being thrown.
+         *
+         * @param ec error condition (see thread::join(std::error_code &)), cleared on success.
+         */
+        void join(std::error_code &ec) noexcept;
+
+        /** joins this thread if it has ended.
+         *
+         * @return true if the thread was joined (or was not started), false if it is still running.
+         * @see thread::try_join
+         */
+        bool try_join();
+
+        /** joins this thread, waiting at most the given time for it to end.
+         *
+         * @param millis milliseconds to wait for the thread to end.
+         * @return true if the thread was joined (or was not started), false if the timeout expired.
+         * @see thread::join_for
+         */
+        bool join_for(int millis);
+
         /** @return true if this thread can be joined.
          */
         bool joinable() const;
 
+        /** @return the stack size reserved for this thread, in bytes (0 means default size, if the thread was not started yet).
+         */
+        std::size_t stack_size() const;
+
+        /** @return peak stack usage in bytes, 0 (zero) if the thread was not started or its stack was not measured.
+         * @see thread::stack_usage
+         */
+        std::size_t stack_usage() const;
+
+        /** @return thread's name (empty if the thread is not named)
+         */
+        const std::string &name() const {
+            return _name;
+        }
+
+        /** @return resources consumed by this thread (all figures are 0 if the thread was not started).
+         * @see thread::accounting
+         */
+        thread_accounting accounting() const;
+
         /** not copy-assignable */
         void operator=(const abstract_thread &) = delete;
 
     private:
+
+        /** start running on behalf of a thread group.
+         */
+        void start(const std::shared_ptr<thread_group_context> &group);
+
+        /** @return true if the thread has run to completion.
+         */
+        bool ended() const;
+
         pthread::thread *_thread;
         std::size_t _stack_size;
+        std::string _name;
+    };
+
+    /** how thread_group::start() starts the registered threads.
+     */
+    enum class start_mode {
+        immediate, /*!< each thread runs as soon as it is created */
+        barrier    /*!< all threads are created first, then they are released at the same time */
+    };
+
+    /** stack usage statistics of a group of threads.
+     *
+     * Only threads which stack was measured are taken into account (see thread::measure_stack_usage(bool)).
+     */
+    struct stack_usage_summary {
+        unsigned long threads;  //!< number of measured threads
+        std::size_t lowest;     //!< lowest peak stack usage (bytes)
+        std::size_t highest;    //!< highest peak stack usage (bytes)
+        std::size_t average;    //!< average peak stack usage (bytes)
+        std::size_t stack_size; //!< largest stack size reserved by the measured threads (bytes)
     };
 
     /** Group of abstract_threads pointers.
@@ -371,9 +577,13 @@ namespace pthread {
 
         /** Start running all registered threads.
          *
+         * When start_mode::barrier is used, the threads are all created before being released together. This prevents the
+         * first threads from running long before the last ones exist (benchmarks, warm-up, ...).
+         *
+         * @param mode start threads one after the other (default) or release them at once.
          * @see add(abstract_thread *thread)
          */
-        void start();
+        void start(start_mode mode = start_mode::immediate);
 
         /** Wait for all registered threads to join the caller thread.
          *
@@ -383,11 +593,61 @@ namespace pthread {
          */
         void join();
 
+        /** Wait for any of the registered threads to end and join it.
+         *
+         * The caller wakes up as soon as a thread ends, whatever the order in which the threads were registered.
+         *
+         * > *WARN* only threads started by thread_group::start() notify the group when they end.
+         *
+         * @return the joined thread, nullptr if there is no more thread to join.
+         */
+        abstract_thread *join_any();
+
+        /** Wait, at most the given time, for all registered threads to end.
+         *
+         * The caller wakes up as soon as the last thread ends. Threads that have ended are joined.
+         *
+         * @param millis milliseconds to wait for the threads to end.
+         * @return true if all threads were joined, false if some were still running when the timeout expired.
+         */
+        bool wait_for_all(int millis);
+
+        /** Join the registered threads that have ended, never blocks.
+         *
+         * @return true if all threads were joined, false if some are still running.
+         * @see abstract_thread::try_join
+         */
+        bool try_join();
+
+        /** Join the registered threads, waiting at most the given time (for all of them).
+         *
+         * Unlike wait_for_all(int), this also handles threads that were not started by thread_group::start().
+         *
+         * @param millis milliseconds to wait for the threads to end.
+         * @return true if all threads were joined, false if some were still running when the timeout expired.
+         * @see abstract_thread::join_for
+         */
+        bool join_for(int millis);
+
         /**
          * @return the number of threads in the thread_group
          */
         unsigned long size();
 
+        /** Summarize the peak stack usage of the registered threads.
+         *
+         * Compare `highest` with `stack_size` to size the stacks of this group's threads.
+         *
+         * @return stack usage statistics (all fields are 0 if no stack was measured).
+         * @see thread::measure_stack_usage(bool)
+         */
+        stack_usage_summary stack_usage() const;
+
+        /** @return resources consumed by each registered thread (in registration order).
+         * @see abstract_thread::accounting
+         */
+        std::vector<thread_accounting> accounting() const;
+
         /** @return current value of destructor_joins_first property. If true the destructor shall try to join registered threads before destroying them.
          */
         const bool destructor_joins_first() { return _destructor_joins_first; };
@@ -401,6 +661,7 @@ namespace pthread {
     private:
         std::list<pthread::abstract_thread *> _threads;
         bool _destructor_joins_first;
+        std::shared_ptr<thread_group_context> _context; //!< created when the threads are started
     };
 
     /** \namespace pthread::this_thread
@@ -415,9 +676,94 @@ namespace pthread {
         /** let the current thread sleep for the given milliseconds.
          *
          * @param millis time to wait.
+         * @throw pthread_exception if millis is negative.
          */
         void sleep_for(const int millis);
 
+        /** let the current thread sleep for the given duration (nanosecond resolution).
+         *
+         * The sleep is resumed when a signal handler interrupts it.
+         *
+         * @param duration time to wait, nothing is done if it's not positive.
+         * @throw pthread_exception if the system call failed.
+         * @see sleep_until
+         */
+        void sleep_for(std::chrono::nanoseconds duration);
+
+        /** let the current thread sleep for the given duration, the last spin nanoseconds are spent spinning (see
+         * sleep_until(std::chrono::steady_clock::time_point, std::chrono::nanoseconds)).
+         *
+         * @param duration time to wait.
+         * @param spin part of duration spent spinning instead of sleeping.
+         * @throw pthread_exception if the system call failed.
+         */
+        void sleep_for(std::chrono::nanoseconds duration, std::chrono::nanoseconds spin);
+
+        /** let the current thread sleep until the monotonic clock reaches deadline.
+         *
+         * The deadline is absolute (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) where available): the sleep is resumed
+         * when a signal handler interrupts it and, in a periodic loop, the time spent between two sleeps doesn't add up.
+         *
+         * <pre><code>
+         * auto next = std::chrono::steady_clock::now();
+         * for (;;) {
+         *   next += std::chrono::microseconds(500);
+         *   pthread::this_thread::sleep_until(next);
+         *   send(packet);
+         * }
+         * </code></pre>
+         *
+         * @param deadline when to wake up, returns immediately if it's already reached.
+         * @throw pthread_exception if the system call failed.
+         */
+        void sleep_until(std::chrono::steady_clock::time_point deadline);
+
+        /** hybrid sleep: sleep until deadline - spin, and then spin (pause instructions) until deadline is reached.
+         *
+         * The OS wakes sleeping threads up a little late (timer slack, scheduling), spinning the last microseconds makes
+         * the wake up accurate at the cost of the CPU time spent spinning. A spin of a few tens of microseconds is a good
+         * start.
+         *
+         * @param deadline when to wake up.
+         * @param spin time spent spinning before the deadline (0 means sleep only).
+         * @throw pthread_exception if the system call failed.
+         */
+        void sleep_until(std::chrono::steady_clock::time_point deadline, std::chrono::nanoseconds spin);
+
+        /** let the current thread sleep until deadline (of any clock) is reached.
+         *
+         * @param deadline when to wake up, converted to the steady clock.
+         * @throw pthread_exception if the system call failed.
+         */
+        template<class Clock, class Duration>
+        void sleep_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+            sleep_until(detail::steady_deadline(deadline));
+        }
+
+        /** give up the CPU to another thread (sched_yield). */
+        inline void yield() noexcept {
+            sched_yield();
+        }
+
+        /** tell the CPU that the calling thread is busy waiting (pause instruction, see util::cpu_relax()). */
+        inline void pause() noexcept {
+            util::cpu_relax();
+        }
+
+        /** let the current thread sleep for the given duration (i.e. std::chrono::microseconds(50)).
+         *
+         * @param duration time to wait, rounded up to the nanosecond.
+         * @throw pthread_exception if the system call failed.
+         */
+        template<class Rep, class Period>
+        void sleep_for(const std::chrono::duration<Rep, Period> &duration) {
+            auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+            if (nanos < duration) {
+                ++nanos;
+            }
+            sleep_for(nanos);
+        }
+
         /** @return current thread id/reference */
         pthread_t get_id();
         /** @} */
@@ -0,0 +1,289 @@
+//
+//  thread_specific.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_thread_specific_hpp
+#define pthread_thread_specific_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "pthread/exceptions.hpp"
+#include "pthread/mutex.hpp"
+#include "pthread/lock_guard.hpp"
+
+namespace pthread {
+
+    /** \addtogroup threads
+     *
+     * @{
+     */
+
+    /** One instance of T per thread (thread local storage).
+     *
+     * Each thread that accesses a thread_specific gets its own instance of T, created on first access. The instance is
+     * deleted when its thread ends (pthread key destructor). Live instances can be visited, this is handy to aggregate
+     * per-thread counters or statistic shards.
+     *
+     * <pre><code>
+     * pthread::thread_specific<std::atomic<long>> hits;
+     *
+     * void worker::run() noexcept {
+     *   ...
+     *   (*hits)++ ; // no contention, each thread increments its own counter
+     * }
+     *
+     * long total = 0;
+     * hits.for_each([&total](std::atomic<long> &count){ total += count; });
+     * </code></pre>
+     *
+     * Reading the current thread's instance uses a `thread_local` cache when the compiler supports it, pthread_getspecific
+     * is then only called the first time a thread accesses a given thread_specific (or when it alternates between several
+     * thread_specific of the same type).
+     *
+     * @tparam T type of the per-thread instances.
+     * @see pthread_key_create
+     * @see pthread_getspecific
+     */
+    template<typename T> class thread_specific {
+    public:
+
+        /** instances are default constructed.
+         *
+         * @throw pthread_exception if the pthread key cannot be created.
+         */
+        thread_specific();
+
+        /** instances are created by calling the given factory.
+         *
+         * @param factory returns a new instance (allocated with new).
+         * @throw pthread_exception if the pthread key cannot be created.
+         */
+        explicit thread_specific(std::function<T *()> factory);
+
+        /** deletes the pthread key and all live instances (whatever thread they belong to).
+         *
+         * > *WARN* the threads must not use this instance anymore.
+         */
+        ~thread_specific();
+
+        /** @return the calling thread's instance (created on first access).
+         */
+        T *get();
+
+        /** @return the calling thread's instance (created on first access).
+         */
+        T &operator*() {
+            return *get();
+        }
+
+        /** @return the calling thread's instance (created on first access).
+         */
+        T *operator->() {
+            return get();
+        }
+
+        /** visit each live instance.
+         *
+         * Instances are not deleted while being visited (ending threads wait). The owning threads may still be using them,
+         * the visitor must therefore access thread safe members only (atomics, ...).
+         *
+         * @param visitor called with a reference to each live instance.
+         */
+        template<typename Visitor>
+        void for_each(Visitor visitor);
+
+        /** @return number of live instances (threads that accessed this thread_specific and are still running).
+         */
+        std::size_t size();
+
+        /** not copy-assignable */
+        thread_specific(const thread_specific &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const thread_specific &) = delete;
+
+    private:
+
+        /** per-thread instance, linked to the other live instances. */
+        struct node {
+            T *value;
+            thread_specific *owner;
+            node *previous;
+            node *next;
+        };
+
+        /** last instance accessed by the current thread. */
+        struct cache {
+            std::uint64_t id;
+            T *value;
+        };
+
+#if __cplusplus >= 201103L
+        static cache &local_cache() {
+            static thread_local cache local = {0, nullptr};
+            return local;
+        }
+#endif
+
+        /** @return a unique identifier (identifiers are never reused, so a stale cache never matches). */
+        static std::uint64_t next_id() {
+            static std::atomic<std::uint64_t> id{0};
+            return ++id;
+        }
+
+        /** pthread key destructor, called by an ending thread. */
+        static void destroy(void *data);
+
+        /** create and register the calling thread's instance. */
+        node *create();
+
+        /** unlink a node (_mutex must be held). */
+        void unlink(node *entry);
+
+        void init();
+
+        pthread_key_t _key;
+        std::uint64_t _id;
+        std::function<T *()> _factory;
+        pthread::mutex _mutex; //!< protects the list of live instances
+        node *_nodes;
+    };
+
+    /** @} */
+
+    // template implementation ----------------------
+
+    template<typename T>
+    thread_specific<T>::thread_specific(): _id(next_id()), _factory([] { return new T(); }), _nodes(nullptr) {
+        init();
+    }
+
+    template<typename T>
+    thread_specific<T>::thread_specific(std::function<T *()> factory): _id(next_id()), _factory(factory), _nodes(nullptr) {
+        init();
+    }
+
+    template<typename T>
+    void thread_specific<T>::init() {
+        int rc = pthread_key_create(&_key, &thread_specific<T>::destroy);
+        if (rc != 0) {
+            throw_exception(pthread_exception("pthread_key_create failed.", rc));
+        }
+    }
+
+    template<typename T>
+    thread_specific<T>::~thread_specific() {
+        pthread_key_delete(_key); // ending threads won't call destroy anymore
+
+        pthread::lock_guard<pthread::mutex> lck(_mutex);
+        while (_nodes != nullptr) {
+            node *entry = _nodes;
+            unlink(entry);
+            delete entry->value;
+            delete entry;
+        }
+    }
+
+    template<typename T>
+    T *thread_specific<T>::get() {
+#if __cplusplus >= 201103L
+        cache &local = local_cache();
+        if (local.id == _id) {
+            return local.value;
+        }
+#endif
+
+        node *entry = static_cast<node *>(pthread_getspecific(_key));
+        if (entry == nullptr) {
+            entry = create();
+        }
+
+#if __cplusplus >= 201103L
+        local.id = _id;
+        local.value = entry->value;
+#endif
+
+        return entry->value;
+    }
+
+    template<typename T>
+    template<typename Visitor>
+    void thread_specific<T>::for_each(Visitor visitor) {
+        pthread::lock_guard<pthread::mutex> lck(_mutex);
+        for (node *entry = _nodes; entry != nullptr; entry = entry->next) {
+            visitor(*entry->value);
+        }
+    }
+
+    template<typename T>
+    std::size_t thread_specific<T>::size() {
+        std::size_t count = 0;
+        for_each([&count](T &) { count++; });
+        return count;
+    }
+
+    template<typename T>
+    typename thread_specific<T>::node *thread_specific<T>::create() {
+        node *entry = new node{_factory(), this, nullptr, nullptr};
+
+        int rc = pthread_setspecific(_key, entry);
+        if (rc != 0) {
+            delete entry->value;
+            delete entry;
+            throw_exception(pthread_exception("pthread_setspecific failed.", rc));
+        }
+
+        pthread::lock_guard<pthread::mutex> lck(_mutex);
+        entry->next = _nodes;
+        if (_nodes != nullptr) {
+            _nodes->previous = entry;
+        }
+        _nodes = entry;
+
+        return entry;
+    }
+
+    template<typename T>
+    void thread_specific<T>::unlink(node *entry) {
+        if (entry->previous != nullptr) {
+            entry->previous->next = entry->next;
+        } else {
+            _nodes = entry->next;
+        }
+        if (entry->next != nullptr) {
+            entry->next->previous = entry->previous;
+        }
+    }
+
+    template<typename T>
+    void thread_specific<T>::destroy(void *data) {
+        node *entry = static_cast<node *>(data);
+
+#if __cplusplus >= 201103L
+        // other key destructors may still run on this thread, they must not find a deleted instance in the cache.
+        cache &local = local_cache();
+        if (local.value == entry->value) {
+            local.id = 0;
+            local.value = nullptr;
+        }
+#endif
+
+        {
+            pthread::lock_guard<pthread::mutex> lck(entry->owner->_mutex);
+            entry->owner->unlink(entry);
+        }
+
+        delete entry->value;
+        delete entry;
+    }
+
+} // namespace pthread
+
+#endif /* pthread_thread_specific_hpp */
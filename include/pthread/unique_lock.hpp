@@ -0,0 +1,349 @@
+//
+//  unique_lock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_unique_lock_hpp
+#define pthread_unique_lock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+#include <sched.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include "pthread/exceptions.hpp"
+#include "pthread/lock_guard.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Movable mutex ownership wrapper.
+     *
+     * Unlike lock_guard, a unique_lock may or may not own its mutex: locking can be deferred, tried or adopted, the mutex
+     * can be unlocked and locked again, and the ownership can be moved to another unique_lock (i.e. returned by a
+     * function). The mutex is unlocked when a unique_lock that owns it is destroyed.
+     *
+     * <pre><code>
+     * pthread::unique_lock<pthread::mutex> from_lock{from.mutex, pthread::defer_lock};
+     * pthread::unique_lock<pthread::mutex> to_lock{to.mutex, pthread::defer_lock};
+     * pthread::lock(from_lock, to_lock); // no deadlock, whatever the order used by other threads
+     * from.balance -= amount;
+     * to.balance += amount;
+     * </code></pre>
+     *
+     * @tparam MutexType a kind of mutex (lock, try_lock returning a bool and unlock).
+     */
+    template<class MutexType>
+    class unique_lock {
+    public:
+
+        /** a unique_lock without mutex. */
+        unique_lock() noexcept: _mutex(nullptr), _owns(false) {
+        }
+
+        /** lock the mutex (blocks until the mutex is available).
+         *
+         * @param mutex mutex to own.
+         */
+        explicit unique_lock(MutexType &mutex) : _mutex(&mutex), _owns(false) {
+            _mutex->lock();
+            _owns = true;
+        }
+
+        /** reference the mutex, don't lock it.
+         *
+         * @param mutex mutex to lock later.
+         */
+        unique_lock(MutexType &mutex, defer_lock_t) noexcept: _mutex(&mutex), _owns(false) {
+        }
+
+        /** try to lock the mutex, doesn't block (see owns_lock).
+         *
+         * @param mutex mutex to own.
+         */
+        unique_lock(MutexType &mutex, try_to_lock_t) : _mutex(&mutex), _owns(mutex.try_lock()) {
+        }
+
+        /** take ownership of a mutex that the calling thread already locked.
+         *
+         * @param mutex mutex locked by the calling thread.
+         */
+        unique_lock(MutexType &mutex, adopt_lock_t) noexcept: _mutex(&mutex), _owns(true) {
+        }
+
+        /** move constructor, other doesn't reference a mutex anymore.
+         *
+         * @param other unique_lock to move.
+         */
+        unique_lock(unique_lock &&other) noexcept: _mutex(other._mutex), _owns(other._owns) {
+            other._mutex = nullptr;
+            other._owns = false;
+        }
+
+        /** move assignment, the currently owned mutex (if any) is unlocked.
+         *
+         * @param other unique_lock to move.
+         * @return this instance
+         */
+        unique_lock &operator=(unique_lock &&other) {
+            if (this != &other) {
+                if (_owns) {
+                    _mutex->unlock();
+                }
+                _mutex = other._mutex;
+                _owns = other._owns;
+                other._mutex = nullptr;
+                other._owns = false;
+            }
+            return *this;
+        }
+
+        /** unlock the mutex if it's owned. */
+        ~unique_lock() {
+            if (_owns) {
+                _mutex->unlock();
+            }
+        }
+
+        /** lock the mutex.
+         *
+         * @throw mutex_exception if there is no mutex (EPERM) or if the mutex is already owned (EDEADLK).
+         */
+        void lock() {
+            check(false);
+            _mutex->lock();
+            _owns = true;
+        }
+
+        /** try to lock the mutex, doesn't block.
+         *
+         * @return true if the mutex is now owned.
+         * @throw mutex_exception if there is no mutex (EPERM) or if the mutex is already owned (EDEADLK).
+         */
+        bool try_lock() {
+            check(false);
+            _owns = _mutex->try_lock();
+            return _owns;
+        }
+
+        /** unlock the mutex.
+         *
+         * @throw mutex_exception if the mutex is not owned (EPERM).
+         */
+        void unlock() {
+            check(true);
+            _mutex->unlock();
+            _owns = false;
+        }
+
+        /** dissociate the mutex without unlocking it.
+         *
+         * @return the mutex (the caller is now in charge of unlocking it if it was owned).
+         */
+        MutexType *release() noexcept {
+            MutexType *mutex = _mutex;
+            _mutex = nullptr;
+            _owns = false;
+            return mutex;
+        }
+
+        /** exchange states with another unique_lock.
+         *
+         * @param other unique_lock to swap with.
+         */
+        void swap(unique_lock &other) noexcept {
+            MutexType *mutex = _mutex;
+            bool owns = _owns;
+            _mutex = other._mutex;
+            _owns = other._owns;
+            other._mutex = mutex;
+            other._owns = owns;
+        }
+
+        /** @return true if the mutex is locked by this instance. */
+        bool owns_lock() const noexcept {
+            return _owns;
+        }
+
+        /** @return true if the mutex is locked by this instance. */
+        explicit operator bool() const noexcept {
+            return _owns;
+        }
+
+        /** @return the referenced mutex (nullptr if there is none). */
+        MutexType *mutex() const noexcept {
+            return _mutex;
+        }
+
+        /** not copy-assignable */
+        unique_lock(const unique_lock &) = delete;
+
+        /** not copy-assignable */
+        unique_lock &operator=(const unique_lock &) = delete;
+
+    private:
+
+        void check(bool owned) const {
+            if (_mutex == nullptr) {
+                throw_exception(mutex_exception("unique_lock doesn't reference a mutex.", EPERM));
+            }
+            if (owned && !_owns) {
+                throw_exception(mutex_exception("unique_lock doesn't own its mutex.", EPERM));
+            }
+            if (!owned && _owns) {
+                throw_exception(mutex_exception("unique_lock already owns its mutex.", EDEADLK));
+            }
+        }
+
+        MutexType *_mutex;
+        bool _owns;
+    };
+
+    namespace detail {
+
+        /** type erased lockable, used by the multi-lock algorithms. */
+        struct lockable_reference {
+            void *lockable;
+            void (*lock)(void *);
+            bool (*try_lock)(void *);
+            void (*unlock)(void *);
+        };
+
+        template<class Lockable>
+        lockable_reference make_lockable_reference(Lockable &lockable) {
+            return lockable_reference{
+                    &lockable,
+                    [](void *target) { static_cast<Lockable *>(target)->lock(); },
+                    [](void *target) { return static_cast<Lockable *>(target)->try_lock(); },
+                    [](void *target) { static_cast<Lockable *>(target)->unlock(); }
+            };
+        }
+
+        /** unlock locks[first] up to locks[last - 1]. */
+        inline void unlock_range(lockable_reference *locks, std::size_t first, std::size_t last) {
+            for (std::size_t index = first; index < last; index++) {
+                locks[index].unlock(locks[index].lockable);
+            }
+        }
+
+        /** @return -1 if all the locks were acquired, or the index of the first one that was busy (nothing is then held). */
+        inline int try_lock_all(lockable_reference *locks, std::size_t count) {
+            std::size_t index = 0;
+
+            CPP_PTHREAD_TRY {
+                while (index < count && locks[index].try_lock(locks[index].lockable)) {
+                    index++;
+                }
+            } CPP_PTHREAD_CATCH_ALL {
+                unlock_range(locks, 0, index);
+                CPP_PTHREAD_RETHROW;
+            }
+
+            if (index < count) {
+                unlock_range(locks, 0, index);
+                return static_cast<int>(index);
+            }
+
+            return -1;
+        }
+
+        /* block on one lock, try the others in order. If one is busy, release everything, yield and start again by
+         * blocking on the busy one: a thread never waits while holding a lock, so there is no deadlock.
+         */
+        inline void lock_all(lockable_reference *locks, std::size_t count) {
+            std::size_t first = 0;
+
+            for (;;) {
+                locks[first].lock(locks[first].lockable);
+
+                std::size_t busy = count;
+                std::size_t offset = 1;
+                CPP_PTHREAD_TRY {
+                    for (; offset < count; offset++) {
+                        std::size_t index = (first + offset) % count;
+                        if (!locks[index].try_lock(locks[index].lockable)) {
+                            busy = index;
+                            break;
+                        }
+                    }
+                } CPP_PTHREAD_CATCH_ALL {
+                    for (std::size_t held = 0; held < offset; held++) {
+                        std::size_t index = (first + held) % count;
+                        locks[index].unlock(locks[index].lockable);
+                    }
+                    CPP_PTHREAD_RETHROW;
+                }
+
+                if (busy == count) {
+                    return; // all locked
+                }
+
+                for (std::size_t held = 0; held < offset; held++) {
+                    std::size_t index = (first + held) % count;
+                    locks[index].unlock(locks[index].lockable);
+                }
+
+                sched_yield(); // give the owner of the busy lock a chance to release it
+                first = busy;
+            }
+        }
+    }
+
+    /** Lock all the given lockables without deadlock.
+     *
+     * Whatever the order in which threads pass the same mutexes, they don't deadlock: the calling thread blocks on one
+     * mutex only, and tries to lock the others. If one of them is busy, all the mutexes are released, the thread yields
+     * the CPU and starts again by blocking on the busy mutex.
+     *
+     * <pre><code>
+     * pthread::lock(from.mutex, to.mutex);
+     * pthread::lock_guard<pthread::mutex> from_guard{from.mutex, pthread::adopt_lock};
+     * pthread::lock_guard<pthread::mutex> to_guard{to.mutex, pthread::adopt_lock};
+     * </code></pre>
+     *
+     * If an exception is thrown, no lockable is held on return.
+     *
+     * @param first a lockable (lock, try_lock returning a bool and unlock), i.e. pthread::mutex or pthread::unique_lock.
+     * @param second a lockable.
+     * @param others more lockables.
+     */
+    template<class Lockable1, class Lockable2, class... Lockables>
+    void lock(Lockable1 &first, Lockable2 &second, Lockables &... others) {
+        detail::lockable_reference locks[] = {
+                detail::make_lockable_reference(first),
+                detail::make_lockable_reference(second),
+                detail::make_lockable_reference(others)...
+        };
+        detail::lock_all(locks, 2 + sizeof...(others));
+    }
+
+    /** Try to lock all the given lockables, in order, without blocking.
+     *
+     * @param first a lockable (lock, try_lock returning a bool and unlock).
+     * @param second a lockable.
+     * @param others more lockables.
+     * @return -1 if all the lockables are now locked, else the (0 based) index of the first lockable that couldn't be locked
+     *         (none is then held).
+     */
+    template<class Lockable1, class Lockable2, class... Lockables>
+    int try_lock(Lockable1 &first, Lockable2 &second, Lockables &... others) {
+        detail::lockable_reference locks[] = {
+                detail::make_lockable_reference(first),
+                detail::make_lockable_reference(second),
+                detail::make_lockable_reference(others)...
+        };
+        return detail::try_lock_all(locks, 2 + sizeof...(others));
+    }
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_unique_lock_hpp */
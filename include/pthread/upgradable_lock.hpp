@@ -0,0 +1,205 @@
+//
+//  upgradable_lock.hpp
+//  cpp-pthread
+//
+
+#ifndef pthread_upgradable_lock_hpp
+#define pthread_upgradable_lock_hpp
+
+// WARN pthread.h must be include as first hearder file of each source code file (see IBM's
+// recommandation for more info p.285 chapter 8.3.1).
+#include <pthread.h>
+
+#include <cstddef>
+
+#include "pthread/exceptions.hpp"
+#include "pthread/mutex.hpp"
+#include "pthread/condition_variable.hpp"
+
+namespace pthread {
+
+    /** \addtogroup concurrency
+     *
+     * @{
+     */
+
+    /** Read lock of an upgradable_read_write_lock.
+     *
+     * This class cannot be instantiated, create an upgradable_read_write_lock and pass it to a lock_guard<upgradable_read_lock>
+     * to get a read lock.
+     */
+    class upgradable_read_lock {
+    public:
+
+        /** apply a read lock, wait while a writer holds or waits for the lock.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        void lock();
+
+        /** @return true if the read lock was acquired, false if a writer holds or waits for the lock.
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock();
+
+        /** release the read lock.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        void unlock();
+
+        /** not copy-assignable */
+        upgradable_read_lock(const upgradable_read_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const upgradable_read_lock &) = delete;
+
+    protected:
+
+        /** create an unlocked lock.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        upgradable_read_lock();
+
+        /** not virtual, an upgradable_read_write_lock can't be deleted through a pointer to its read lock. */
+        ~upgradable_read_lock() = default;
+
+        /** @return true if a reader can enter. */
+        bool readable() const noexcept {
+            return !_writer && _writers_waiting == 0;
+        }
+
+        pthread::mutex _mutex;                        //!< protects the lock state
+        pthread::condition_variable _readers_cv;      //!< readers and upgraders wait for the writers
+        pthread::condition_variable _writers_cv;      //!< writers and promoting upgraders wait for the readers
+
+        std::size_t _readers;         //!< readers that hold the lock (the upgrader is not counted)
+        std::size_t _writers_waiting; //!< writers (and the promoting upgrader) waiting for the lock
+        bool _upgrader;               //!< an upgrader holds the lock
+        bool _writer;                 //!< a writer (or the promoted upgrader) holds the lock exclusively
+    };
+
+    /** Upgrade lock of an upgradable_read_write_lock.
+     *
+     * The upgrade lock is a read lock that only one thread can hold at a time, and that can be promoted to a write lock
+     * without being released.
+     */
+    class upgrade_lock : public upgradable_read_lock {
+    public:
+
+        /** apply an upgrade lock, wait for the current upgrader or writer to release the lock.
+         *
+         * Plain readers share the lock with the upgrader.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        void lock();
+
+        /** @return true if the upgrade lock was acquired, false if a writer or an upgrader holds (or waits for) the lock.
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock();
+
+        /** release the upgrade lock (or the write lock if it was promoted).
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        void unlock();
+
+        /** promote the upgrade lock to a write lock, without releasing it.
+         *
+         * New readers wait, the calling thread waits for the current readers to leave. No writer can change the data between
+         * the upgrade lock and the write lock.
+         *
+         * @throw read_write_lock_exception if the lock is not held by an upgrader (EPERM).
+         */
+        void promote();
+
+        /** turn the write lock back into an upgrade lock, readers get the lock.
+         *
+         * @throw read_write_lock_exception if the lock was not promoted (EPERM).
+         */
+        void demote();
+
+        /** not copy-assignable */
+        upgrade_lock(const upgrade_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const upgrade_lock &) = delete;
+
+    protected:
+
+        /** create an unlocked lock. */
+        upgrade_lock() = default;
+
+        /** not virtual, an upgradable_read_write_lock can't be deleted through a pointer to its upgrade lock. */
+        ~upgrade_lock() = default;
+    };
+
+    /** Write lock of an upgradable_read_write_lock.
+     */
+    class upgradable_write_lock : public upgrade_lock {
+    public:
+
+        /** apply a write lock, wait for the readers, the upgrader and the current writer to release the lock.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        void lock();
+
+        /** @return true if the write lock was acquired, false if the lock is held.
+         * @throw mutex_exception if error conditions preventing this method to succeed.
+         */
+        bool try_lock();
+
+        /** release the write lock.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        void unlock();
+
+        /** create an unlocked lock.
+         *
+         * @throw mutex_exception or condition_variable_exception if error conditions preventing this method to succeed.
+         */
+        upgradable_write_lock() = default;
+
+        /** not copy-assignable */
+        upgradable_write_lock(const upgradable_write_lock &) = delete;
+
+        /** not copy-assignable */
+        void operator=(const upgradable_write_lock &) = delete;
+    };
+
+    /** A read/write lock with an upgrade mode.
+     *
+     * Besides readers and writers, one thread at a time can hold an upgrade lock: it shares the lock with plain readers
+     * and can be promoted to a write lock without being released. This fits "read, then write if needed" patterns (i.e.
+     * filling a cache): the data read by the upgrader can't change before it's promoted, so there's no need to check
+     * it again, and threads that only read are not stopped while the upgrader looks up the data.
+     *
+     * Waiting writers (and a promoting upgrader) stop new readers. This lock uses a mutex and condition variables, it's
+     * meant for critical sections that are longer than the lock handling.
+     *
+     * <pre><code>
+     * pthread::upgradable_read_write_lock rwlock;
+     *
+     * {
+     *   pthread::lock_guard<pthread::upgrade_lock> lock(rwlock);
+     *   if (cache.find(key) == cache.end()) {
+     *     rwlock.promote(); // released by lock_guard
+     *     cache[key] = load(key);
+     *   }
+     * }
+     * </code></pre>
+     *
+     * Readers use lock_guard<pthread::upgradable_read_lock> and writers use lock_guard<pthread::upgradable_write_lock>.
+     */
+    typedef upgradable_write_lock upgradable_read_write_lock;
+
+    /** @} */
+
+} // namespace pthread
+
+#endif /* pthread_upgradable_lock_hpp */
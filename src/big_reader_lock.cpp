@@ -0,0 +1,55 @@
+//
+//  big_reader_lock.cpp
+//  cpp-pthread
+//
+
+#include "pthread/big_reader_lock.hpp"
+#include "pthread/lock_guard.hpp"
+
+namespace pthread {
+
+    // big_reader_read_lock -----------------------------
+    //
+    big_reader_read_lock::big_reader_read_lock() : _writer(false) {
+    }
+
+    big_reader_read_lock::~big_reader_read_lock() = default;
+
+    void big_reader_read_lock::lock_slow(detail::read_indicator::slot &local) {
+        local.readers.fetch_sub(1, std::memory_order_release);
+
+        // the writer holds _writers until it releases the lock, no writer can come in while the slot is updated.
+        pthread::lock_guard<pthread::mutex> wait_for_writer(_writers);
+        local.readers.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // big_reader_write_lock -----------------------------
+    //
+    void big_reader_write_lock::lock() {
+        _writers.lock();
+        _writer.store(true, std::memory_order_seq_cst);
+        _readers.wait_until_empty();
+    }
+
+    bool big_reader_write_lock::try_lock() noexcept {
+        std::error_code ec;
+        if (!_writers.try_lock(ec)) {
+            return false;
+        }
+
+        _writer.store(true, std::memory_order_seq_cst);
+        if (!_readers.empty()) {
+            _writer.store(false, std::memory_order_release);
+            _writers.unlock(ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    void big_reader_write_lock::unlock() {
+        _writer.store(false, std::memory_order_release);
+        _writers.unlock();
+    }
+
+} // namespace pthread
@@ -1,9 +1,21 @@
 #include "pthread/condition_variable.hpp"
+#include "pthread/lock_profile.hpp"
+
+#include <unistd.h>
 
 namespace pthread {
 
   void condition_variable::wait(mutex &mtx) {
+    profiled_mutex *profiled = profiled_mutex::waiting(mtx);
     pthread_cond_wait ( &_condition, &mtx._mutex);
+    profiled_mutex::woken(profiled);
+  }
+
+  void condition_variable::wait(mutex &mtx, std::error_code &ec) noexcept {
+    profiled_mutex *profiled = profiled_mutex::waiting(mtx);
+    int rc = pthread_cond_wait ( &_condition, &mtx._mutex);
+    profiled_mutex::woken(profiled);
+    ec.assign(rc, std::system_category());
   }
 
   void condition_variable::wait(lock_guard<pthread::mutex> lck){
@@ -14,76 +26,118 @@ namespace pthread {
     return wait_for(*(lck._mutex), millis);
   }
 
-  /* Default millis is 0 */
   cv_status condition_variable::wait_for ( mutex &mtx, int millis ) {
-    int rc = 0;
-    cv_status status = no_timeout;
+    return wait_until(mtx, std::chrono::steady_clock::now() + std::chrono::milliseconds(millis));
+  }
 
-    if ( millis >= 0) {
-      milliseconds(millis);
-    }
+  cv_status condition_variable::wait_for ( mutex &mtx, int millis, std::error_code &ec ) noexcept {
+    return wait_until(mtx, std::chrono::steady_clock::now() + std::chrono::milliseconds(millis), ec);
+  }
 
-    rc  = pthread_cond_timedwait ( &_condition, &mtx._mutex, &timeout );
+  cv_status condition_variable::wait_until ( mutex &mtx, std::chrono::steady_clock::time_point deadline ) {
+    int rc = timed_wait(mtx, deadline);
 
     switch (rc){
 
       case ETIMEDOUT:
-        status = timedout;
-        break;
+        return timedout;
 
       case EINVAL:
-        throw condition_variable_exception("The value specified by abstime is invalid.", rc);
+        throw_exception(condition_variable_exception("The value specified by abstime is invalid.", rc));
 
       case EPERM:
-        throw condition_variable_exception("The mutex was not owned by the current thread at the time of the call.", rc);
+        throw_exception(condition_variable_exception("The mutex was not owned by the current thread at the time of the call.", rc));
 
       default:
-        status = no_timeout ;
-        break;
+        return no_timeout ;
+    }
+  }
+
+  cv_status condition_variable::wait_until ( mutex &mtx, std::chrono::steady_clock::time_point deadline, std::error_code &ec ) noexcept {
+    int rc = timed_wait(mtx, deadline);
+
+    if ( rc == ETIMEDOUT ){
+      ec.clear();
+      return timedout;
+    }
+
+    ec.assign(rc, std::system_category());
+    return no_timeout;
+  }
+
+  int condition_variable::timed_wait ( mutex &mtx, std::chrono::steady_clock::time_point deadline ) noexcept {
+    timespec abstime;
+
+    if ( _clock == CLOCK_MONOTONIC ){
+      // the steady clock is CLOCK_MONOTONIC
+      auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+      if ( since_epoch < 0 ){
+        since_epoch = 0;
+      }
+      abstime.tv_sec = static_cast<time_t>(since_epoch / 1000000000);
+      abstime.tv_nsec = static_cast<long>(since_epoch % 1000000000);
+    } else {
+      // the condition uses CLOCK_REALTIME, convert the remaining time into a wall clock deadline.
+      auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+      if ( remaining < 0 ){
+        remaining = 0;
+      }
+
+      clock_gettime(CLOCK_REALTIME, &abstime);
+      long long nanos = abstime.tv_nsec + remaining;
+      abstime.tv_sec += static_cast<time_t>(nanos / 1000000000);
+      abstime.tv_nsec = static_cast<long>(nanos % 1000000000);
     }
 
-    return status;
+    profiled_mutex *profiled = profiled_mutex::waiting(mtx);
+    int rc = pthread_cond_timedwait ( &_condition, &mtx._mutex, &abstime );
+    profiled_mutex::woken(profiled);
+
+    return rc;
   }
 
   void condition_variable::notify_one(){
     int rc = pthread_cond_signal ( &_condition );
     if ( rc != 0 ){
-      throw condition_variable_exception{"notify_all failed.", rc};
+      throw_exception(condition_variable_exception{"notify_all failed.", rc});
     }
   }
 
+  void condition_variable::notify_one(std::error_code &ec) noexcept {
+    ec.assign(pthread_cond_signal ( &_condition ), std::system_category());
+  }
+
   void condition_variable::notify_all () {
     int rc = pthread_cond_broadcast ( &_condition );
     if ( rc != 0 ){
-        throw condition_variable_exception{"notify_all failed.", rc};
+        throw_exception(condition_variable_exception{"notify_all failed.", rc});
     }
   }
 
-  void condition_variable::milliseconds(int millis){
-    timeval  now;
-
-    if ( gettimeofday ( &now, NULL ) == 0){
-      timeout.tv_sec = now.tv_sec;
-      // iss-44 - cppcheck - timeout.tv_nsec= now.tv_usec * 1000 ;
+  void condition_variable::notify_all(std::error_code &ec) noexcept {
+    ec.assign(pthread_cond_broadcast ( &_condition ), std::system_category());
+  }
 
-      auto seconds = millis / 1000;
-      auto nanos   = (now.tv_usec * 1000) + ((millis % 1000) * 1000000) ;
-      seconds     += nanos / 1000000000 ; // check if now + millis id not overflowing.
-      nanos        = nanos % 1000000000 ;
+  // constuctors & destructors --------------
 
-      timeout.tv_sec  += seconds ;
-      timeout.tv_nsec  = nanos;
-    } else {
-      throw condition_variable_exception("failed to get current time.");
+  condition_variable::condition_variable (): _clock(CLOCK_REALTIME) {
+    pthread_condattr_t attr;
+    int rc = pthread_condattr_init ( &attr );
+    if ( rc != 0 ){
+      throw_exception(condition_variable_exception("pthread_condattr_init failed.", rc));
     }
-  }
 
-  // constuctors & destructors --------------
+#if defined(_POSIX_CLOCK_SELECTION) && _POSIX_CLOCK_SELECTION > 0 && defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+    // timeouts don't move when the system time is changed
+    if ( pthread_condattr_setclock ( &attr, CLOCK_MONOTONIC ) == 0 ){
+      _clock = CLOCK_MONOTONIC;
+    }
+#endif
 
-  condition_variable::condition_variable () {
-    int rc = pthread_cond_init ( &_condition, NULL );
+    rc = pthread_cond_init ( &_condition, &attr );
+    pthread_condattr_destroy ( &attr );
     if ( rc != 0 ){
-      throw condition_variable_exception("pthread_cond_init failed.", rc);
+      throw_exception(condition_variable_exception("pthread_cond_init failed.", rc));
     }
   }
 
@@ -92,7 +146,7 @@ namespace pthread {
     if (rc != 0){
       // This is the only way to signal that the destruction of the ressource failed, so the rule "Destructors should not throw exceptions" is therfore ignored.
       //
-      throw condition_variable_exception("pthread condition variable destroy failed.", rc); // NOSONAR we decided to make an exception for this one
+      throw_exception(condition_variable_exception("pthread condition variable destroy failed.", rc)); // NOSONAR we decided to make an exception for this one
     }
   }
 
@@ -12,6 +12,56 @@ namespace pthread {
 
     using namespace std;
 
+    namespace {
+
+        /* the library's build mode (CPP_PTHREAD_NO_EXCEPTIONS) decides, whatever the caller's mode is. */
+        template<class Exception>
+        [[noreturn]] void raise(const Exception &exception) {
+#if defined(CPP_PTHREAD_EXCEPTIONS)
+            throw exception;
+#else
+            std::fprintf(stderr, "cpp-pthread: %s\n", exception.what());
+            std::abort();
+#endif
+        }
+    }
+
+    void throw_exception(const pthread_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const timeout_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const mutex_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const read_write_lock_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const condition_variable_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const thread_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const util::queue_exception &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const util::queue_full &exception) {
+        raise(exception);
+    }
+
+    void throw_exception(const util::queue_timeout &exception) {
+        raise(exception);
+    }
+
     pthread_exception::pthread_exception(const string &message, const int error_number) : _message(message),
                                                                                           _error_number(error_number) {
         if (_error_number != 0) {
@@ -0,0 +1,106 @@
+//
+//  futex_mutex.cpp
+//  cpp-pthread
+//
+
+#include "pthread/futex_mutex.hpp"
+
+#if defined(CPP_PTHREAD_HAVE_FUTEX)
+
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace pthread {
+
+    namespace {
+
+        /* sleep as long as *address == expected (relative timeout, null means forever).
+         * Returns 0 or -1 and errno (EAGAIN, EINTR, ETIMEDOUT), none of them are errors for the callers.
+         */
+        long futex_wait(std::atomic<std::uint32_t> &address, std::uint32_t expected, const timespec *timeout = nullptr) noexcept {
+            return syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&address), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+        }
+
+        long futex_wake(std::atomic<std::uint32_t> &address, int count) noexcept {
+            return syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&address), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+    }
+
+    // futex_mutex -----------------------------
+    //
+    void futex_mutex::lock_contended(std::uint32_t state) noexcept {
+        // tell unlock() that someone is (about to be) waiting, then sleep until the mutex is released.
+        if (state != 2) {
+            state = _state.exchange(2, std::memory_order_acquire);
+        }
+        while (state != 0) {
+            futex_wait(_state, 2);
+            state = _state.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    void futex_mutex::unlock_contended() noexcept {
+        _state.store(0, std::memory_order_release);
+        futex_wake(_state, 1);
+    }
+
+    // futex_condition_variable -----------------------------
+    //
+    void futex_condition_variable::wait(futex_mutex &mtx) noexcept {
+        wait_until(mtx, 0);
+    }
+
+    cv_status futex_condition_variable::wait_for(futex_mutex &mtx, int millis) noexcept {
+        return wait_until(mtx, monotonic_nanos() + static_cast<std::int64_t>(millis) * 1000000);
+    }
+
+    cv_status futex_condition_variable::wait_until(futex_mutex &mtx, std::int64_t deadline_nanos) noexcept {
+        cv_status status = no_timeout;
+        std::uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+        mtx.unlock();
+
+        if (deadline_nanos == 0) {
+            futex_wait(_sequence, sequence);
+        } else {
+            std::int64_t remaining = deadline_nanos - monotonic_nanos();
+            if (remaining <= 0) {
+                status = timedout;
+            } else {
+                timespec timeout;
+                timeout.tv_sec = remaining / 1000000000;
+                timeout.tv_nsec = remaining % 1000000000;
+                if (futex_wait(_sequence, sequence, &timeout) != 0 && errno == ETIMEDOUT) {
+                    status = timedout;
+                }
+            }
+        }
+
+        // other threads may have been woken up at the same time, lock as if the mutex was contended.
+        mtx.lock_contended(1);
+
+        return status;
+    }
+
+    void futex_condition_variable::notify_one() noexcept {
+        _sequence.fetch_add(1, std::memory_order_release);
+        futex_wake(_sequence, 1);
+    }
+
+    void futex_condition_variable::notify_all() noexcept {
+        _sequence.fetch_add(1, std::memory_order_release);
+        futex_wake(_sequence, INT_MAX);
+    }
+
+    std::int64_t futex_condition_variable::monotonic_nanos() noexcept {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+} // namespace pthread
+
+#endif
@@ -0,0 +1,436 @@
+//
+//  lock_profile.cpp
+//  cpp-pthread
+//
+
+#include "pthread/lock_profile.hpp"
+#include "pthread/mutex.hpp"
+#include "pthread/lock_guard.hpp"
+#include "pthread/aligned_memory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+
+namespace pthread {
+
+    struct alignas(64) lock_profile::shard {
+        std::atomic<std::uint64_t> acquisitions;
+        std::atomic<std::uint64_t> contended;
+        std::atomic<std::uint64_t> wait_nanos;
+        std::atomic<std::uint64_t> max_wait_nanos;
+        std::atomic<std::uint64_t> hold_nanos;
+        std::atomic<std::uint64_t> wait_histogram[lock_histogram_buckets];
+        std::atomic<std::uint64_t> hold_histogram[lock_histogram_buckets];
+    };
+
+    namespace {
+
+        const std::size_t shards_count = 16; // power of 2
+
+        /* profiles are never destroyed after the registry (named locks can be static objects). */
+        pthread::mutex &registry_mutex() {
+            static pthread::mutex *registry_mutex = new pthread::mutex;
+            return *registry_mutex;
+        }
+
+        std::vector<lock_profile *> &registry() {
+            static std::vector<lock_profile *> *registry = new std::vector<lock_profile *>;
+            return *registry;
+        }
+
+        std::size_t bucket(std::uint64_t nanos) noexcept {
+            std::size_t index = 0;
+            while (nanos != 0 && index < lock_histogram_buckets - 1) {
+                nanos >>= 1;
+                index++;
+            }
+            return index;
+        }
+
+        std::uint64_t nanoseconds(std::chrono::nanoseconds duration) noexcept {
+            return duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0;
+        }
+    }
+
+    lock_profile::lock_profile(const std::string &name) : _name(name), _shards(util::aligned_new<shard>(shards_count)) {
+        reset();
+
+        pthread::lock_guard<pthread::mutex> lock(registry_mutex());
+        registry().push_back(this);
+    }
+
+    lock_profile::~lock_profile() {
+        {
+            pthread::lock_guard<pthread::mutex> lock(registry_mutex());
+            auto &profiles = registry();
+            profiles.erase(std::remove(profiles.begin(), profiles.end(), this), profiles.end());
+        }
+
+        util::aligned_delete(_shards, shards_count);
+    }
+
+    lock_profile::shard &lock_profile::local_shard() noexcept {
+        static std::atomic<std::size_t> next_index{0};
+        static thread_local std::size_t index = next_index.fetch_add(1, std::memory_order_relaxed) & (shards_count - 1);
+
+        return _shards[index];
+    }
+
+    void lock_profile::acquired(bool contended, std::chrono::nanoseconds wait) noexcept {
+        shard &local = local_shard();
+        std::uint64_t nanos = nanoseconds(wait);
+
+        local.acquisitions.fetch_add(1, std::memory_order_relaxed);
+        local.wait_histogram[bucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+        if (contended) {
+            local.contended.fetch_add(1, std::memory_order_relaxed);
+            local.wait_nanos.fetch_add(nanos, std::memory_order_relaxed);
+
+            std::uint64_t max_wait = local.max_wait_nanos.load(std::memory_order_relaxed);
+            while (nanos > max_wait && !local.max_wait_nanos.compare_exchange_weak(max_wait, nanos, std::memory_order_relaxed)) {
+                // max_wait was reloaded
+            }
+        }
+    }
+
+    void lock_profile::released(std::chrono::nanoseconds hold) noexcept {
+        shard &local = local_shard();
+        std::uint64_t nanos = nanoseconds(hold);
+
+        local.hold_nanos.fetch_add(nanos, std::memory_order_relaxed);
+        local.hold_histogram[bucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    lock_statistics lock_profile::statistics() const {
+        lock_statistics statistics{_name, 0, 0, std::chrono::nanoseconds(0), std::chrono::nanoseconds(0), std::chrono::nanoseconds(0), {}, {}};
+        std::uint64_t wait_nanos = 0;
+        std::uint64_t max_wait_nanos = 0;
+        std::uint64_t hold_nanos = 0;
+
+        for (std::size_t index = 0; index < shards_count; index++) {
+            const shard &current = _shards[index];
+
+            statistics.acquisitions += current.acquisitions.load(std::memory_order_relaxed);
+            statistics.contended += current.contended.load(std::memory_order_relaxed);
+            wait_nanos += current.wait_nanos.load(std::memory_order_relaxed);
+            max_wait_nanos = std::max<std::uint64_t>(max_wait_nanos, current.max_wait_nanos.load(std::memory_order_relaxed));
+            hold_nanos += current.hold_nanos.load(std::memory_order_relaxed);
+
+            for (std::size_t bucket = 0; bucket < lock_histogram_buckets; bucket++) {
+                statistics.wait_histogram[bucket] += current.wait_histogram[bucket].load(std::memory_order_relaxed);
+                statistics.hold_histogram[bucket] += current.hold_histogram[bucket].load(std::memory_order_relaxed);
+            }
+        }
+
+        statistics.wait_time = std::chrono::nanoseconds(wait_nanos);
+        statistics.max_wait = std::chrono::nanoseconds(max_wait_nanos);
+        statistics.hold_time = std::chrono::nanoseconds(hold_nanos);
+
+        return statistics;
+    }
+
+    void lock_profile::reset() noexcept {
+        for (std::size_t index = 0; index < shards_count; index++) {
+            shard &current = _shards[index];
+
+            current.acquisitions.store(0, std::memory_order_relaxed);
+            current.contended.store(0, std::memory_order_relaxed);
+            current.wait_nanos.store(0, std::memory_order_relaxed);
+            current.max_wait_nanos.store(0, std::memory_order_relaxed);
+            current.hold_nanos.store(0, std::memory_order_relaxed);
+
+            for (std::size_t bucket = 0; bucket < lock_histogram_buckets; bucket++) {
+                current.wait_histogram[bucket].store(0, std::memory_order_relaxed);
+                current.hold_histogram[bucket].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<lock_statistics> lock_profile::top_contended(std::size_t count) {
+        std::vector<lock_statistics> top;
+
+        {
+            pthread::lock_guard<pthread::mutex> lock(registry_mutex());
+            for (auto profile: registry()) {
+                top.push_back(profile->statistics());
+            }
+        }
+
+        std::sort(top.begin(), top.end(), [](const lock_statistics &left, const lock_statistics &right) {
+            return left.contended != right.contended ? left.contended > right.contended : left.wait_time > right.wait_time;
+        });
+
+        if (top.size() > count) {
+            top.resize(count);
+        }
+
+        return top;
+    }
+
+    void lock_profile::report(std::ostream &out, std::size_t count) {
+        std::ostringstream table; // the caller's stream formatting is left unchanged
+
+        table << std::left << std::setw(24) << "lock" << std::right
+            << std::setw(14) << "acquisitions"
+            << std::setw(12) << "contended"
+            << std::setw(10) << "rate(%)"
+            << std::setw(14) << "avg wait(us)"
+            << std::setw(14) << "max wait(us)"
+            << std::setw(14) << "avg hold(us)" << "\n";
+
+        for (auto &statistics: top_contended(count)) {
+            double acquisitions = statistics.acquisitions > 0 ? static_cast<double>(statistics.acquisitions) : 1.0;
+            double contended = statistics.contended > 0 ? static_cast<double>(statistics.contended) : 1.0;
+
+            std::uint64_t holds = 0;
+            for (auto held: statistics.hold_histogram) {
+                holds += held;
+            }
+
+            table << std::left << std::setw(24) << statistics.name << std::right << std::fixed << std::setprecision(2)
+                << std::setw(14) << statistics.acquisitions
+                << std::setw(12) << statistics.contended
+                << std::setw(10) << statistics.contended * 100.0 / acquisitions
+                << std::setw(14) << statistics.wait_time.count() / contended / 1000.0
+                << std::setw(14) << statistics.max_wait.count() / 1000.0
+                << std::setw(14) << (holds > 0 ? statistics.hold_time.count() / static_cast<double>(holds) / 1000.0 : 0.0)
+                << "\n";
+        }
+
+        out << table.str() << std::flush;
+    }
+
+    // profiled_mutex -----------------------------
+    //
+
+    namespace {
+        // profiled mutexes held by the calling thread, most recently locked first (see profiled_mutex::waiting).
+        thread_local profiled_mutex *held_mutexes = nullptr;
+    }
+
+    profiled_mutex::profiled_mutex(const std::string &name) : mutex(), _profile(name), _depth(0), _next_held(nullptr) {
+    }
+
+    profiled_mutex::profiled_mutex(const std::string &name, const mutex_attributes &attributes) : mutex(attributes), _profile(name), _depth(0), _next_held(nullptr) {
+    }
+
+    void profiled_mutex::lock() {
+        auto since = std::chrono::steady_clock::now();
+
+        bool contended = !mutex::try_lock();
+        if (contended) {
+            mutex::lock();
+        }
+        acquired(contended, since);
+    }
+
+    void profiled_mutex::lock(std::error_code &ec) noexcept {
+        auto since = std::chrono::steady_clock::now();
+
+        bool contended = !mutex::try_lock(ec) && !ec;
+        if (contended) {
+            mutex::lock(ec);
+        }
+        if (!ec || ec.value() == EOWNERDEAD) {
+            acquired(contended, since);
+        }
+    }
+
+    bool profiled_mutex::try_lock() {
+        bool locked = mutex::try_lock();
+        if (locked) {
+            acquired(false, std::chrono::steady_clock::now());
+        }
+        return locked;
+    }
+
+    bool profiled_mutex::try_lock(std::error_code &ec) noexcept {
+        bool locked = mutex::try_lock(ec);
+        if (locked) {
+            acquired(false, std::chrono::steady_clock::now());
+        }
+        return locked;
+    }
+
+    void profiled_mutex::unlock() {
+        releasing();
+        mutex::unlock();
+    }
+
+    void profiled_mutex::unlock(std::error_code &ec) noexcept {
+        releasing();
+        mutex::unlock(ec);
+    }
+
+    void profiled_mutex::acquired(bool contended, std::chrono::steady_clock::time_point since) noexcept {
+        auto now = std::chrono::steady_clock::now();
+        if (_depth++ == 0) {
+            _acquired_at = now;
+            _next_held = held_mutexes;
+            held_mutexes = this;
+        }
+        _profile.acquired(contended, contended ? now - since : std::chrono::nanoseconds(0));
+    }
+
+    void profiled_mutex::releasing() noexcept {
+        if (_depth == 0 || --_depth > 0) {
+            return; // not locked by the caller, or a recursive mutex that is still held
+        }
+
+        _profile.released(std::chrono::steady_clock::now() - _acquired_at);
+
+        profiled_mutex **link = &held_mutexes;
+        while (*link != nullptr && *link != this) {
+            link = &(*link)->_next_held;
+        }
+        if (*link != nullptr) {
+            *link = _next_held;
+        }
+    }
+
+    profiled_mutex *profiled_mutex::waiting(const mutex &mtx) noexcept {
+        profiled_mutex *held = held_mutexes;
+        while (held != nullptr && static_cast<const mutex *>(held) != &mtx) {
+            held = held->_next_held;
+        }
+
+        if (held != nullptr) {
+            held->_profile.released(std::chrono::steady_clock::now() - held->_acquired_at);
+        }
+        return held;
+    }
+
+    void profiled_mutex::woken(profiled_mutex *mtx) noexcept {
+        if (mtx != nullptr) {
+            mtx->_acquired_at = std::chrono::steady_clock::now();
+        }
+    }
+
+    // profiled_read_lock -----------------------------
+    //
+
+    profiled_read_lock::profiled_read_lock(const std::string &name) : _rwlock(), _profile(name) {
+    }
+
+    profiled_read_lock::profiled_read_lock(const std::string &name, rwlock_policy policy) : _rwlock(policy), _profile(name) {
+    }
+
+    void profiled_read_lock::lock() {
+        auto since = std::chrono::steady_clock::now();
+
+        read_lock &reader = _rwlock;
+        bool contended = !reader.try_lock();
+        if (contended) {
+            reader.lock();
+        }
+        acquired(contended, since);
+    }
+
+    void profiled_read_lock::lock(std::error_code &ec) noexcept {
+        auto since = std::chrono::steady_clock::now();
+
+        read_lock &reader = _rwlock;
+        bool contended = !reader.try_lock(ec) && !ec;
+        if (contended) {
+            reader.lock(ec);
+        }
+        if (!ec) {
+            acquired(contended, since);
+        }
+    }
+
+    bool profiled_read_lock::try_lock() {
+        read_lock &reader = _rwlock;
+        bool locked = reader.try_lock();
+        if (locked) {
+            acquired(false, std::chrono::steady_clock::now());
+        }
+        return locked;
+    }
+
+    bool profiled_read_lock::try_lock(std::error_code &ec) noexcept {
+        read_lock &reader = _rwlock;
+        bool locked = reader.try_lock(ec);
+        if (locked) {
+            acquired(false, std::chrono::steady_clock::now());
+        }
+        return locked;
+    }
+
+    void profiled_read_lock::unlock() {
+        _rwlock.unlock();
+    }
+
+    void profiled_read_lock::unlock(std::error_code &ec) noexcept {
+        _rwlock.unlock(ec);
+    }
+
+    void profiled_read_lock::acquired(bool contended, std::chrono::steady_clock::time_point since) noexcept {
+        _profile.acquired(contended, contended ? std::chrono::steady_clock::now() - since : std::chrono::nanoseconds(0));
+    }
+
+    // profiled_write_lock -----------------------------
+    //
+
+    profiled_write_lock::profiled_write_lock(const std::string &name) : profiled_read_lock(name) {
+    }
+
+    profiled_write_lock::profiled_write_lock(const std::string &name, rwlock_policy policy) : profiled_read_lock(name, policy) {
+    }
+
+    void profiled_write_lock::lock() {
+        auto since = std::chrono::steady_clock::now();
+
+        bool contended = !_rwlock.try_lock();
+        if (contended) {
+            _rwlock.lock();
+        }
+        acquired(contended, since);
+    }
+
+    void profiled_write_lock::lock(std::error_code &ec) noexcept {
+        auto since = std::chrono::steady_clock::now();
+
+        bool contended = !_rwlock.try_lock(ec) && !ec;
+        if (contended) {
+            _rwlock.lock(ec);
+        }
+        if (!ec) {
+            acquired(contended, since);
+        }
+    }
+
+    bool profiled_write_lock::try_lock() {
+        bool locked = _rwlock.try_lock();
+        if (locked) {
+            acquired(false, std::chrono::steady_clock::now());
+        }
+        return locked;
+    }
+
+    bool profiled_write_lock::try_lock(std::error_code &ec) noexcept {
+        bool locked = _rwlock.try_lock(ec);
+        if (locked) {
+            acquired(false, std::chrono::steady_clock::now());
+        }
+        return locked;
+    }
+
+    void profiled_write_lock::unlock() {
+        _profile.released(std::chrono::steady_clock::now() - _acquired_at);
+        _rwlock.unlock();
+    }
+
+    void profiled_write_lock::unlock(std::error_code &ec) noexcept {
+        _profile.released(std::chrono::steady_clock::now() - _acquired_at);
+        _rwlock.unlock(ec);
+    }
+
+    void profiled_write_lock::acquired(bool contended, std::chrono::steady_clock::time_point since) noexcept {
+        _acquired_at = std::chrono::steady_clock::now();
+        _profile.acquired(contended, contended ? _acquired_at - since : std::chrono::nanoseconds(0));
+    }
+
+} // namespace pthread
@@ -0,0 +1,145 @@
+//
+//  mcs_lock.cpp
+//  cpp-pthread
+//
+
+#include "pthread/mcs_lock.hpp"
+#include "pthread/spin_lock.hpp"
+#include "pthread/aligned_memory.hpp"
+
+#include <cstdint>
+#include <sched.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pthread {
+
+    struct alignas(64) mcs_lock::node {
+        std::atomic<node *> next;
+        std::atomic<std::uint32_t> state; // see waiting, granted, parked
+        bool in_use;                      // node is taken from the thread's pool
+        bool allocated;                   // pool was exhausted, node was allocated with util::aligned_new
+    };
+
+    namespace {
+
+        const std::uint32_t waiting = 0;
+        const std::uint32_t granted = 1;
+        const std::uint32_t parked = 2;
+
+        const int spin_budget = 2000;  // cpu_relax() calls before a waiting thread goes to sleep
+        const int pool_size = 4;       // locks a thread can hold at the same time without allocating nodes
+
+        thread_local mcs_lock::node pool[pool_size];
+
+        mcs_lock::node *acquire_node() noexcept {
+            mcs_lock::node *entry = nullptr;
+            for (int index = 0; index < pool_size && entry == nullptr; index++) {
+                if (!pool[index].in_use) {
+                    entry = &pool[index];
+                    entry->allocated = false;
+                }
+            }
+            if (entry == nullptr) {
+                entry = util::aligned_new<mcs_lock::node>(); // new doesn't align on cache lines before C++17
+                entry->allocated = true;
+            }
+
+            entry->in_use = true;
+            entry->next.store(nullptr, std::memory_order_relaxed);
+            entry->state.store(waiting, std::memory_order_relaxed);
+
+            return entry;
+        }
+
+        void release_node(mcs_lock::node *entry) noexcept {
+            if (entry->allocated) {
+                util::aligned_delete(entry);
+            } else {
+                entry->in_use = false;
+            }
+        }
+
+        /* spin on our own node, then sleep until the predecessor grants us the lock. */
+        void wait_for_grant(mcs_lock::node *entry) noexcept {
+            for (int count = spin_budget; count > 0; count--) {
+                if (entry->state.load(std::memory_order_acquire) == granted) {
+                    return;
+                }
+                util::cpu_relax();
+            }
+
+            std::uint32_t state = waiting;
+            if (entry->state.compare_exchange_strong(state, parked, std::memory_order_acquire, std::memory_order_acquire)) {
+                state = parked;
+            }
+            while (state != granted) {
+#if defined(__linux__)
+                syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&entry->state), FUTEX_WAIT_PRIVATE, parked, nullptr, nullptr, 0);
+#else
+                sched_yield();
+#endif
+                state = entry->state.load(std::memory_order_acquire);
+            }
+        }
+
+        void grant(mcs_lock::node *entry) noexcept {
+            if (entry->state.exchange(granted, std::memory_order_release) == parked) {
+#if defined(__linux__)
+                syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&entry->state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+            }
+        }
+    }
+
+    void mcs_lock::lock() noexcept {
+        node *entry = acquire_node();
+
+        node *predecessor = _tail.exchange(entry, std::memory_order_acq_rel);
+        if (predecessor != nullptr) {
+            predecessor->next.store(entry, std::memory_order_release);
+            wait_for_grant(entry);
+        }
+
+        _owner = entry;
+    }
+
+    bool mcs_lock::try_lock() noexcept {
+        node *entry = acquire_node();
+
+        node *tail = nullptr;
+        if (_tail.compare_exchange_strong(tail, entry, std::memory_order_acquire, std::memory_order_relaxed)) {
+            _owner = entry;
+            return true;
+        }
+
+        release_node(entry);
+        return false;
+    }
+
+    void mcs_lock::unlock() noexcept {
+        node *entry = _owner;
+
+        node *successor = entry->next.load(std::memory_order_acquire);
+        if (successor == nullptr) {
+            node *tail = entry;
+            if (_tail.compare_exchange_strong(tail, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                release_node(entry);
+                return;
+            }
+
+            // a thread is queuing up, wait for it to link itself to our node.
+            while ((successor = entry->next.load(std::memory_order_acquire)) == nullptr) {
+                util::cpu_relax();
+            }
+        }
+
+        grant(successor);
+        release_node(entry);
+    }
+
+} // namespace pthread
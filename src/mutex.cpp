@@ -7,13 +7,125 @@
 //
 
 #include "pthread/mutex.hpp"
+#include <unistd.h>
+#include <ctime>
 
 namespace pthread {
 
-    mutex::mutex() {
+    // mutex_attributes -----------------------------
+    //
+    mutex_attributes::mutex_attributes() {
+        auto rc = pthread_mutexattr_init(&_attributes);
+        if (rc != 0) {
+            throw_exception(mutex_exception("pthread_mutexattr_init failed.", rc));
+        }
+    }
+
+    mutex_attributes::~mutex_attributes() {
+        pthread_mutexattr_destroy(&_attributes);
+    }
+
+    mutex_attributes &mutex_attributes::type(mutex_type type) {
+        int kind = PTHREAD_MUTEX_DEFAULT;
+
+        switch (type) {
+            case mutex_type::recursive:
+                kind = PTHREAD_MUTEX_RECURSIVE;
+                break;
+            case mutex_type::error_check:
+                kind = PTHREAD_MUTEX_ERRORCHECK;
+                break;
+            case mutex_type::adaptive:
+#if defined(__GLIBC__)
+                kind = PTHREAD_MUTEX_ADAPTIVE_NP;
+                break;
+#else
+                throw_exception(mutex_exception("adaptive mutexes are not supported on this platform.", ENOTSUP));
+#endif
+            default:
+                kind = PTHREAD_MUTEX_DEFAULT;
+                break;
+        }
+
+        auto rc = pthread_mutexattr_settype(&_attributes, kind);
+        if (rc != 0) {
+            throw_exception(mutex_exception("pthread_mutexattr_settype failed.", rc));
+        }
+
+        return *this;
+    }
+
+    mutex_attributes &mutex_attributes::robust(bool robust) {
+#if defined(_POSIX_THREAD_ROBUST_PRIO_INHERIT) || defined(_POSIX_THREAD_ROBUST_PRIO_PROTECT)
+        auto rc = pthread_mutexattr_setrobust(&_attributes, robust ? PTHREAD_MUTEX_ROBUST : PTHREAD_MUTEX_STALLED);
+        if (rc != 0) {
+            throw_exception(mutex_exception("pthread_mutexattr_setrobust failed.", rc));
+        }
+#else
+        if (robust) {
+            throw_exception(mutex_exception("robust mutexes are not supported on this platform.", ENOTSUP));
+        }
+#endif
+        return *this;
+    }
+
+    mutex_attributes &mutex_attributes::protocol(mutex_protocol protocol) {
+        int value = PTHREAD_PRIO_NONE;
+
+        switch (protocol) {
+            case mutex_protocol::inherit:
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && _POSIX_THREAD_PRIO_INHERIT > 0
+                value = PTHREAD_PRIO_INHERIT;
+                break;
+#else
+                throw_exception(mutex_exception("priority inheritance is not supported on this platform.", ENOTSUP));
+#endif
+            case mutex_protocol::protect:
+#if defined(_POSIX_THREAD_PRIO_PROTECT) && _POSIX_THREAD_PRIO_PROTECT > 0
+                value = PTHREAD_PRIO_PROTECT;
+                break;
+#else
+                throw_exception(mutex_exception("priority protection is not supported on this platform.", ENOTSUP));
+#endif
+            default:
+                value = PTHREAD_PRIO_NONE;
+                break;
+        }
+
+        auto rc = pthread_mutexattr_setprotocol(&_attributes, value);
+        if (rc != 0) {
+            throw_exception(mutex_exception("pthread_mutexattr_setprotocol failed.", rc));
+        }
+
+        return *this;
+    }
+
+    mutex_attributes &mutex_attributes::priority_ceiling(int ceiling) {
+#if defined(_POSIX_THREAD_PRIO_PROTECT) && _POSIX_THREAD_PRIO_PROTECT > 0
+        auto rc = pthread_mutexattr_setprioceiling(&_attributes, ceiling);
+        if (rc != 0) {
+            throw_exception(mutex_exception("pthread_mutexattr_setprioceiling failed.", rc));
+        }
+#else
+        throw_exception(mutex_exception("priority protection is not supported on this platform.", ENOTSUP));
+#endif
+        return *this;
+    }
+
+    // mutex -----------------------------
+    //
+
+    mutex::mutex(): _owner_died(false) {
         auto rc = pthread_mutex_init(&_mutex, NULL);
         if (rc != 0) {
-            throw mutex_exception("In constructor of mutex pthread_mutex_init(&mutex, NULL) failed. ", rc);
+            throw_exception(mutex_exception("In constructor of mutex pthread_mutex_init(&mutex, NULL) failed. ", rc));
+        }
+    }
+
+    mutex::mutex(const mutex_attributes &attributes): _owner_died(false) {
+        auto rc = pthread_mutex_init(&_mutex, &attributes._attributes);
+        if (rc != 0) {
+            throw_exception(mutex_exception("In constructor of mutex pthread_mutex_init(&mutex, &attributes) failed. ", rc));
         }
     }
 
@@ -21,34 +133,105 @@ namespace pthread {
         pthread_mutex_destroy(&_mutex);
     }
 
-    void mutex::lock() {
-        int rc = -1;
-        rc = pthread_mutex_lock(&_mutex);
+    void mutex::lock_failed(int rc) {
+        if (rc == EOWNERDEAD) {
+            _owner_died = true; // the caller owns the mutex, it must repair the state and call consistent()
+            return;
+        }
+        throw_exception(mutex_exception("pthread_mutex_lock failed.", rc));
+    }
+
+    void mutex::try_lock_failed(int rc) {
+        if (rc == EOWNERDEAD) {
+            _owner_died = true; // the caller owns the mutex, it must repair the state and call consistent()
+            return;
+        }
+        throw_exception(mutex_exception("pthread_mutex_trylock failed, already locked.", rc));
+    }
+
+    void mutex::unlock_failed(int rc) {
+        throw_exception(mutex_exception("pthread_mutex_unlock failed.", rc));
+    }
+
+    void mutex::consistent() {
+#if defined(_POSIX_THREAD_ROBUST_PRIO_INHERIT) || defined(_POSIX_THREAD_ROBUST_PRIO_PROTECT)
+        auto rc = pthread_mutex_consistent(&_mutex);
         if (rc != 0) {
-            throw mutex_exception("pthread_mutex_lock failed.", rc);
+            throw_exception(mutex_exception("pthread_mutex_consistent failed.", rc));
         }
+        _owner_died = false;
+#else
+        throw_exception(mutex_exception("robust mutexes are not supported on this platform.", ENOTSUP));
+#endif
     }
 
-    bool mutex::try_lock() {
-        bool status = false;
+    // timed_mutex -----------------------------
+    //
+
+    bool timed_mutex::try_lock_for(int millis) {
+        return try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(millis));
+    }
 
-        auto rc = pthread_mutex_trylock(&_mutex);
-        if (rc == 0) {
-            status = true; // mutex is locked now
-        }else if ( rc == EBUSY){
-            status = false ; // mutex is held by some other thread
-        } else {
-            throw mutex_exception("pthread_mutex_trylock failed, already locked.", rc);
+    bool timed_mutex::try_lock_for(int millis, std::error_code &ec) noexcept {
+        return try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(millis), ec);
+    }
+
+    bool timed_mutex::try_lock_until(std::chrono::steady_clock::time_point deadline) {
+        std::error_code ec;
+        bool status = try_lock_until(deadline, ec);
+        if (ec && ec.value() != EOWNERDEAD) { // EOWNERDEAD: the mutex is locked (see owner_died())
+            throw_exception(mutex_exception("pthread_mutex_timedlock failed.", ec.value()));
         }
 
-        return status ;
+        return status;
     }
 
-    void mutex::unlock() {
-        auto rc = pthread_mutex_unlock(&_mutex);
-        if (rc != 0) {
-            throw mutex_exception("pthread_mutex_unlock failed.", rc);
+    bool timed_mutex::try_lock_until(std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept {
+#if defined(_POSIX_TIMEOUTS) && _POSIX_TIMEOUTS > 0
+        timespec abstime;
+        int rc = 0;
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+        // the steady clock is CLOCK_MONOTONIC
+        auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+        abstime.tv_sec = static_cast<time_t>(since_epoch / 1000000000);
+        abstime.tv_nsec = static_cast<long>(since_epoch % 1000000000);
+
+        rc = pthread_mutex_clocklock(&_mutex, CLOCK_MONOTONIC, &abstime);
+#else
+        // pthread_mutex_timedlock only knows about CLOCK_REALTIME, convert the remaining time into a wall clock deadline.
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining < 0) {
+            remaining = 0;
+        }
+
+        clock_gettime(CLOCK_REALTIME, &abstime);
+        long long nanos = abstime.tv_nsec + remaining;
+        abstime.tv_sec += static_cast<time_t>(nanos / 1000000000);
+        abstime.tv_nsec = static_cast<long>(nanos % 1000000000);
+
+        rc = pthread_mutex_timedlock(&_mutex, &abstime);
+#endif
+
+        if (rc == ETIMEDOUT) {
+            ec.clear();
+            return false;
+        } else if (rc == EOWNERDEAD) {
+            _owner_died = true;
+        }
+
+        ec.assign(rc, std::system_category());
+        return rc == 0 || rc == EOWNERDEAD;
+#else
+        // no pthread_mutex_timedlock (i.e. macOS), poll the mutex.
+        bool locked = try_lock(ec);
+        while (!locked && !ec && std::chrono::steady_clock::now() < deadline) {
+            timespec pause{0, 100000}; // 100us
+            nanosleep(&pause, nullptr);
+            locked = try_lock(ec);
         }
+        return locked;
+#endif
     }
 
 }
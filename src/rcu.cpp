@@ -0,0 +1,174 @@
+//
+//  rcu.cpp
+//  cpp-pthread
+//
+
+#include "pthread/rcu.hpp"
+#include "pthread/spin_lock.hpp"
+#include "pthread/aligned_memory.hpp"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pthread {
+
+    namespace {
+
+        const std::size_t retired_batch = 128;  // retired pointers that make retire() wait for a grace period
+
+#if defined(__linux__) && defined(SYS_membarrier)
+        int membarrier(int command) noexcept {
+            return static_cast<int>(syscall(SYS_membarrier, command, 0));
+        }
+#endif
+
+        /* releases the reader slot of a thread when it ends. */
+        struct reader_release {
+            std::atomic<std::uint64_t> *epoch = nullptr;
+            std::atomic<bool> *in_use = nullptr;
+
+            ~reader_release() {
+                if (in_use != nullptr) {
+                    epoch->store(0, std::memory_order_release); // the thread may have ended within a read-side critical section
+                    in_use->store(false, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local reader_release local_release;
+    }
+
+    thread_local rcu_domain::reader *rcu_domain::_local_reader = nullptr;
+
+    rcu_domain &rcu_domain::global() {
+        static rcu_domain *domain = new rcu_domain; // readers may still run while static objects are destroyed
+        return *domain;
+    }
+
+    rcu_domain::rcu_domain() : _epoch(1), _readers(nullptr), _membarrier(false) {
+#if defined(__linux__) && defined(SYS_membarrier)
+        int commands = membarrier(MEMBARRIER_CMD_QUERY);
+        _membarrier = commands > 0 &&
+                      (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0 &&
+                      membarrier(MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED) == 0;
+#endif
+    }
+
+    rcu_domain::reader *rcu_domain::register_reader() noexcept {
+        reader *slot = nullptr;
+
+        // reuse the slot of a thread that ended
+        for (reader *current = _readers.load(std::memory_order_acquire); current != nullptr && slot == nullptr; current = current->next) {
+            bool in_use = false;
+            if (!current->in_use.load(std::memory_order_relaxed) &&
+                current->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+                slot = current;
+            }
+        }
+
+        if (slot == nullptr) {
+            slot = util::aligned_new<reader>(); // new doesn't align on cache lines before C++17
+            slot->epoch.store(0, std::memory_order_relaxed);
+            slot->in_use.store(true, std::memory_order_relaxed);
+
+            reader *head = _readers.load(std::memory_order_relaxed);
+            do {
+                slot->next = head;
+            } while (!_readers.compare_exchange_weak(head, slot, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        slot->nesting = 0;
+        local_release.epoch = &slot->epoch;
+        local_release.in_use = &slot->in_use;
+        _local_reader = slot;
+
+        return slot;
+    }
+
+    void rcu_domain::heavy_fence() noexcept {
+#if defined(__linux__) && defined(SYS_membarrier)
+        if (_membarrier && membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED) == 0) {
+            return;
+        }
+#endif
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    std::uint64_t rcu_domain::oldest_reader_epoch() const noexcept {
+        std::uint64_t oldest = _epoch.load(std::memory_order_acquire);
+
+        for (reader *current = _readers.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+            std::uint64_t epoch = current->epoch.load(std::memory_order_acquire);
+            if (epoch != 0 && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+
+        return oldest;
+    }
+
+    void rcu_domain::synchronize() {
+        if (in_read_section()) {
+            throw_exception(pthread_exception("rcu_domain::synchronize() was called within a read-side critical section.", EDEADLK));
+        }
+
+        heavy_fence(); // readers see the data published before, their epochs are visible
+        const std::uint64_t epoch = _epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+        for (reader *current = _readers.load(std::memory_order_acquire); current != nullptr; current = current->next) {
+            util::spin_wait([current, epoch] {
+                const std::uint64_t entered = current->epoch.load(std::memory_order_acquire);
+                return entered == 0 || entered >= epoch; // outside of a read section, or entered after the grace period started
+            });
+        }
+
+        heavy_fence(); // the readers are done with what they read
+    }
+
+    void rcu_domain::retire(void *pointer, void (*deleter)(void *)) {
+        std::size_t pending = 0;
+        {
+            pthread::lock_guard<pthread::mutex> lock(_retired_mutex);
+            _retired.push_back(retired_pointer{pointer, deleter, _epoch.load(std::memory_order_seq_cst)});
+            pending = _retired.size();
+        }
+
+        if (pending >= retired_batch && !in_read_section()) {
+            synchronize();
+            reclaim();
+        }
+    }
+
+    std::size_t rcu_domain::reclaim() {
+        heavy_fence();
+        _epoch.fetch_add(1, std::memory_order_seq_cst); // new readers can't see what was retired so far
+        const std::uint64_t oldest = oldest_reader_epoch();
+
+        std::vector<retired_pointer> expired;
+        {
+            pthread::lock_guard<pthread::mutex> lock(_retired_mutex);
+            auto still_used = std::partition(_retired.begin(), _retired.end(), [oldest](const retired_pointer &retired) {
+                return retired.epoch < oldest; // every reader entered after the pointer was retired
+            });
+            expired.assign(_retired.begin(), still_used);
+            _retired.erase(_retired.begin(), still_used);
+        }
+
+        for (auto &retired: expired) {
+            retired.deleter(retired.pointer);
+        }
+
+        return expired.size();
+    }
+
+    std::size_t rcu_domain::retired() const {
+        pthread::lock_guard<pthread::mutex> lock(_retired_mutex);
+        return _retired.size();
+    }
+
+} // namespace pthread
@@ -0,0 +1,61 @@
+//
+//  read_indicator.cpp
+//  cpp-pthread
+//
+
+#include "pthread/read_indicator.hpp"
+#include "pthread/spin_lock.hpp"
+#include "pthread/aligned_memory.hpp"
+
+#include <unistd.h>
+
+namespace pthread {
+
+    namespace detail {
+
+        namespace {
+
+            std::size_t slots_count() noexcept {
+                long cpus = sysconf(_SC_NPROCESSORS_CONF);
+                std::size_t count = 1;
+                while (cpus > 0 && count < static_cast<std::size_t>(cpus) && count < 1024) {
+                    count <<= 1;
+                }
+                return count;
+            }
+        }
+
+        read_indicator::read_indicator() : _slots(nullptr), _mask(slots_count() - 1) {
+            _slots = util::aligned_new<slot>(_mask + 1); // new doesn't align on cache lines before C++17
+            for (std::size_t index = 0; index <= _mask; index++) {
+                _slots[index].readers.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        read_indicator::~read_indicator() {
+            util::aligned_delete(_slots, _mask + 1);
+        }
+
+        bool read_indicator::empty() const noexcept {
+            for (std::size_t index = 0; index <= _mask; index++) {
+                if (_slots[index].readers.load(std::memory_order_seq_cst) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void read_indicator::wait_until_empty() const noexcept {
+            for (std::size_t index = 0; index <= _mask; index++) {
+                const slot &current = _slots[index];
+                util::spin_wait([&current] { return current.readers.load(std::memory_order_seq_cst) == 0; });
+            }
+        }
+
+        std::size_t read_indicator::next_index() noexcept {
+            static std::atomic<std::size_t> threads{0};
+            return threads.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+} // namespace pthread
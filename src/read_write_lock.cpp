@@ -1,21 +1,61 @@
 
 #include "pthread/read_write_lock.hpp"
 
+#include <unistd.h>
+#include <ctime>
 
 namespace pthread {
 
-  void write_lock::lock (){
-    int ret = pthread_rwlock_wrlock(&_rwlock);
+  bool write_lock::try_lock (){
+    int ret = pthread_rwlock_trywrlock(&_rwlock);
+    if ( ret == EBUSY ){
+      return false;
+    }
     if ( ret != 0 ){
-      throw read_write_lock_exception("Try get write lock failed.", ret);
+      failed("Try get write lock failed.", ret);
     }
+    return true;
   }
 
-  void write_lock::try_lock (){
+  bool write_lock::try_lock (std::error_code &ec) noexcept {
     int ret = pthread_rwlock_trywrlock(&_rwlock);
+    if ( ret == EBUSY ){
+      ec.clear();
+      return false;
+    }
+
+    ec.assign(ret, std::system_category());
+    return ret == 0;
+  }
+
+  bool write_lock::try_lock_for (int millis){
+    return try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(millis));
+  }
+
+  bool write_lock::try_lock_for (int millis, std::error_code &ec) noexcept {
+    return try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(millis), ec);
+  }
+
+  bool write_lock::try_lock_until (std::chrono::steady_clock::time_point deadline){
+    int ret = timed_lock(true, deadline);
+    if ( ret == ETIMEDOUT ){
+      return false;
+    }
     if ( ret != 0 ){
-      throw read_write_lock_exception("Try get write lock failed.", ret);
+      failed("Timed write lock failed.", ret);
+    }
+    return true;
+  }
+
+  bool write_lock::try_lock_until (std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept {
+    int ret = timed_lock(true, deadline);
+    if ( ret == ETIMEDOUT ){
+      ec.clear();
+      return false;
     }
+
+    ec.assign(ret, std::system_category());
+    return ret == 0;
   }
 
   write_lock::write_lock (){//:read_lock(){
@@ -23,38 +63,145 @@ namespace pthread {
     // the read/write lock is created by the base class read_lock
   }
 
+  write_lock::write_lock (rwlock_policy policy): read_lock(policy){
+    // intentional
+    // the read/write lock is created by the base class read_lock
+  }
+
   write_lock::~write_lock(){
     // intentional... base class is in charge of freeing allocated ressources
   }
 
   // read_lock -----------------------------
   //
-  void read_lock::lock (){
-    int ret = pthread_rwlock_rdlock(&_rwlock);
+  bool read_lock::try_lock (){
+    int ret = pthread_rwlock_tryrdlock(&_rwlock);
+    if ( ret == EBUSY ){
+      return false;
+    }
     if ( ret != 0 ){
-      throw read_write_lock_exception("Try get read lock failed.", ret);
+      failed("Try get read lock failed.", ret);
     }
+    return true;
   }
 
-  void read_lock::try_lock (){
+  bool read_lock::try_lock (std::error_code &ec) noexcept {
     int ret = pthread_rwlock_tryrdlock(&_rwlock);
-    if ( ret != 0 ){
-      throw read_write_lock_exception("Try get read lock failed.", ret);
+    if ( ret == EBUSY ){
+      ec.clear();
+      return false;
     }
+
+    ec.assign(ret, std::system_category());
+    return ret == 0;
   }
 
-  void read_lock::unlock (){
-    int ret = pthread_rwlock_unlock(&_rwlock);
+  bool read_lock::try_lock_for (int millis){
+    return try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(millis));
+  }
+
+  bool read_lock::try_lock_for (int millis, std::error_code &ec) noexcept {
+    return try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(millis), ec);
+  }
+
+  bool read_lock::try_lock_until (std::chrono::steady_clock::time_point deadline){
+    int ret = timed_lock(false, deadline);
+    if ( ret == ETIMEDOUT ){
+      return false;
+    }
     if ( ret != 0 ){
-      throw read_write_lock_exception("failed to unlock read/read lock.", ret);
+      failed("Timed read lock failed.", ret);
     }
+    return true;
+  }
+
+  bool read_lock::try_lock_until (std::chrono::steady_clock::time_point deadline, std::error_code &ec) noexcept {
+    int ret = timed_lock(false, deadline);
+    if ( ret == ETIMEDOUT ){
+      ec.clear();
+      return false;
+    }
+
+    ec.assign(ret, std::system_category());
+    return ret == 0;
+  }
+
+  int read_lock::timed_lock (bool exclusive, std::chrono::steady_clock::time_point deadline) noexcept {
+    int ret = exclusive ? pthread_rwlock_trywrlock(&_rwlock) : pthread_rwlock_tryrdlock(&_rwlock);
+    if ( ret == EBUSY ){
+#if defined(_POSIX_TIMEOUTS) && _POSIX_TIMEOUTS > 0
+      timespec abstime;
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+      // the steady clock is CLOCK_MONOTONIC
+      auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+      abstime.tv_sec = static_cast<time_t>(since_epoch / 1000000000);
+      abstime.tv_nsec = static_cast<long>(since_epoch % 1000000000);
+
+      ret = exclusive ? pthread_rwlock_clockwrlock(&_rwlock, CLOCK_MONOTONIC, &abstime) : pthread_rwlock_clockrdlock(&_rwlock, CLOCK_MONOTONIC, &abstime);
+#else
+      // pthread_rwlock_timed*lock only know about CLOCK_REALTIME, convert the remaining time into a wall clock deadline.
+      auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now()).count();
+      if ( remaining < 0 ){
+        remaining = 0;
+      }
+
+      clock_gettime(CLOCK_REALTIME, &abstime);
+      long long nanos = abstime.tv_nsec + remaining;
+      abstime.tv_sec += static_cast<time_t>(nanos / 1000000000);
+      abstime.tv_nsec = static_cast<long>(nanos % 1000000000);
+
+      ret = exclusive ? pthread_rwlock_timedwrlock(&_rwlock, &abstime) : pthread_rwlock_timedrdlock(&_rwlock, &abstime);
+#endif
+#else
+      // no pthread_rwlock_timed*lock, poll the lock.
+      while ( ret == EBUSY && std::chrono::steady_clock::now() < deadline ){
+        timespec pause{0, 100000}; // 100us
+        nanosleep(&pause, nullptr);
+        ret = exclusive ? pthread_rwlock_trywrlock(&_rwlock) : pthread_rwlock_tryrdlock(&_rwlock);
+      }
+      if ( ret == EBUSY ){
+        ret = ETIMEDOUT;
+      }
+#endif
+    }
+
+    return ret;
+  }
+
+  void read_lock::failed (const char *message, int ret){
+    throw_exception(read_write_lock_exception(message, ret));
   }
 
   read_lock::read_lock (){
     int ret = pthread_rwlock_init(&_rwlock, NULL);
     if ( ret != 0 ){
-      throw read_write_lock_exception("Failed to init read/write lock", ret);
+      throw_exception(read_write_lock_exception("Failed to init read/write lock", ret));
+    }
+  }
+
+  read_lock::read_lock (rwlock_policy policy){
+#if defined(__GLIBC__)
+    pthread_rwlockattr_t attributes;
+    int ret = pthread_rwlockattr_init(&attributes);
+    if ( ret != 0 ){
+      throw_exception(read_write_lock_exception("pthread_rwlockattr_init failed.", ret));
+    }
+
+    // PTHREAD_RWLOCK_PREFER_WRITER_NP is ignored by glibc, only the non recursive flavor prefers writers.
+    ret = pthread_rwlockattr_setkind_np(&attributes, policy == rwlock_policy::prefer_writers ? PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP : PTHREAD_RWLOCK_PREFER_READER_NP);
+    if ( ret == 0 ){
+      ret = pthread_rwlock_init(&_rwlock, &attributes);
+    }
+    pthread_rwlockattr_destroy(&attributes);
+
+    if ( ret != 0 ){
+      throw_exception(read_write_lock_exception("Failed to init read/write lock", ret));
     }
+#else
+    (void) policy;
+    throw_exception(read_write_lock_exception("read/write lock policies are not supported on this platform.", ENOTSUP));
+#endif
   }
 
   read_lock::~read_lock (){
@@ -7,32 +7,299 @@
 //
 
 #include "pthread/thread.hpp"
+#include "pthread/condition_variable.hpp"
 #include <unistd.h>
 #include <cstdio>
 #include <cstring>
 #include <chrono>
 #include <climits>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <ctime>
+#include <sys/resource.h>
+#if defined(__linux__)
+#  include <sys/syscall.h>
+#endif
 
 namespace pthread {
 
-    namespace this_thread {
+    /* painted stack area and results shared by a thread object and the thread it started.
+     *
+     * The running thread holds its own reference, the context therefore outlives the thread object if needed.
+     */
+    struct thread_context {
+        const runnable *runner;
+        bool measure_stack;     // paint and measure the stack
+        std::string name;       // applied by the thread itself when it starts
+        pthread::mutex mutex;   // prevents reading the figures of a thread that is ending
+        pthread::condition_variable ending; // signaled when the thread has finished
+        char *stack_low;        // lowest painted address (null when nothing can be scanned)
+        char *stack_high;       // top of the stack
+        std::size_t stack_usage; // high-water mark measured when the thread ended
+        std::shared_ptr<thread_group_context> group; // notified when the thread ends (may be null)
+
+        bool started;           // the fields below are set once the thread has started
+        bool finished;          // once finished, the fields below hold what the thread consumed
+        long tid;               // kernel thread id (Linux)
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+        std::chrono::nanoseconds cpu_time;
+        long voluntary_context_switches;
+        long involuntary_context_switches;
+
+        thread_context(const runnable *r, bool measure, const std::string &n, const std::shared_ptr<thread_group_context> &g):
+                runner(r), measure_stack(measure), name(n),
+                stack_low(nullptr), stack_high(nullptr), stack_usage(0), group(g), started(false), finished(false), tid(0),
+                cpu_time(0), voluntary_context_switches(0), involuntary_context_switches(0) {
+        }
+    };
 
-        void sleep_for(const int millis) {
-            int rc = -1;
-            if ( millis < 1000 ) {
-                rc = usleep(millis * 1000);
-                if (rc != 0) {
-                    throw pthread_exception("in sleep_for, call to usleep failed. ", errno);
+    /* start gate and end of thread notifications shared by a thread_group and its threads.
+     */
+    struct thread_group_context {
+        pthread::mutex mutex;
+        pthread::condition_variable condition; // signaled when the gate opens and each time a thread ends
+        bool released;                         // start gate is open
+
+        thread_group_context(): released(true) {
+        }
+    };
+
+    namespace {
+
+        std::atomic<bool> measure_stacks{false};
+
+        const unsigned char stack_paint = 0xA5;
+        const std::size_t stack_paint_margin = 4096; // don't paint what's just below the current frame (memset's frame).
+
+        /* paint the unused part of the calling thread's stack, and remember its bounds. */
+        __attribute__((noinline)) void paint_stack(thread_context &context) {
+#if defined(__linux__)
+            pthread_attr_t attr;
+            if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+                void *address = nullptr;
+                std::size_t size = 0;
+                int rc = pthread_attr_getstack(&attr, &address, &size);
+                pthread_attr_destroy(&attr);
+
+                volatile char marker = 0;
+                char *low = static_cast<char *>(address);
+                char *top = const_cast<char *>(&marker) - stack_paint_margin;
+
+                if (rc == 0 && top > low) {
+                    memset(low, stack_paint, top - low);
+
+                    pthread::lock_guard<pthread::mutex> lck(context.mutex);
+                    context.stack_low = low;
+                    context.stack_high = low + size;
                 }
-            } else if ( millis >= 1000 ){
-                rc = sleep( millis / 1000);
-                if (rc != 0) {
-                    throw pthread_exception("in sleep_for, call to sleep failed. ", errno);
+            }
+#endif
+        }
+
+        /* stack bytes overwritten since the stack was painted (context.mutex must be held). */
+        std::size_t scan_stack(const thread_context &context) {
+            const char *cursor = context.stack_low;
+            if (cursor == nullptr) {
+                return 0;
+            }
+
+            // compare words as long as they are aligned, painting is done bytewise.
+            const std::uint64_t painted_word = 0xA5A5A5A5A5A5A5A5ULL;
+            while (cursor < context.stack_high && (reinterpret_cast<std::uintptr_t>(cursor) % sizeof(std::uint64_t)) != 0 &&
+                   static_cast<unsigned char>(*cursor) == stack_paint) {
+                cursor++;
+            }
+            while (cursor + sizeof(std::uint64_t) <= context.stack_high &&
+                   *reinterpret_cast<const volatile std::uint64_t *>(cursor) == painted_word) {
+                cursor += sizeof(std::uint64_t);
+            }
+            while (cursor < context.stack_high && static_cast<unsigned char>(*cursor) == stack_paint) {
+                cursor++;
+            }
+
+            return context.stack_high - cursor;
+        }
+
+        std::chrono::nanoseconds to_nanoseconds(const timespec &time) {
+            return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+        }
+
+        /* name the calling thread (names are limited to 15 characters on Linux). */
+        void set_current_thread_name(const std::string &name) {
+#if defined(__linux__)
+            pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+            pthread_setname_np(name.c_str());
+#endif
+        }
+
+        /* context switches of a running thread, read from /proc/self/task/<tid>/status. */
+        void read_context_switches(long tid, long &voluntary, long &involuntary) {
+#if defined(__linux__)
+            std::ifstream status{"/proc/self/task/" + std::to_string(tid) + "/status"};
+            std::string line;
+            while (std::getline(status, line)) {
+                std::istringstream fields{line};
+                std::string key;
+                fields >> key;
+                if (key == "voluntary_ctxt_switches:") {
+                    fields >> voluntary;
+                } else if (key == "nonvoluntary_ctxt_switches:") {
+                    fields >> involuntary;
                 }
-            } else {
+            }
+#endif
+        }
+
+        /* record what the calling thread consumed (context.mutex must be held). */
+        void record_accounting(thread_context &context) {
+            context.end = std::chrono::steady_clock::now();
+
+            timespec cpu;
+            if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu) == 0) {
+                context.cpu_time = to_nanoseconds(cpu);
+            }
+
+#if defined(RUSAGE_THREAD)
+            rusage usage;
+            if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+                context.voluntary_context_switches = usage.ru_nvcsw;
+                context.involuntary_context_switches = usage.ru_nivcsw;
+            }
+#endif
+        }
+
+        /* pthread_create entry point: names the thread, measures the stack and accounts resources around the runnable's run method. */
+        extern "C" void *thread_startup_context(void *context) {
+            std::unique_ptr<std::shared_ptr<thread_context>> reference{static_cast<std::shared_ptr<thread_context> *>(context)};
+            std::shared_ptr<thread_context> ctx = *reference;
+            reference.reset();
+
+            if (!ctx->name.empty()) {
+                set_current_thread_name(ctx->name);
+            }
+
+            if (ctx->measure_stack) {
+                paint_stack(*ctx);
+            }
+
+            CPP_PTHREAD_TRY {
+                if (ctx->group != nullptr) {
+                    thread_group_context &group = *ctx->group;
+                    pthread::lock_guard<pthread::mutex> lck(group.mutex);
+                    group.condition.wait(group.mutex, [&group] { return group.released; });
+                }
+
+                pthread::lock_guard<pthread::mutex> lck(ctx->mutex);
+#if defined(__linux__)
+                ctx->tid = syscall(SYS_gettid);
+#endif
+                ctx->start = std::chrono::steady_clock::now();
+                ctx->started = true;
+            } CPP_PTHREAD_CATCH_ALL { //NOSONAR threads cannot throw exceptions, this should never happen
+                printf("failed to start accounting in thread_startup_context()."); //NOSONAR this should never happen
+            }
+
+            thread_startup_runnable(const_cast<runnable *>(ctx->runner));
+
+            CPP_PTHREAD_TRY {
+                pthread::lock_guard<pthread::mutex> lck(ctx->mutex);
+                if (ctx->measure_stack) {
+                    ctx->stack_usage = scan_stack(*ctx);
+                    ctx->stack_low = nullptr; // the stack is going to be released
+                }
+                record_accounting(*ctx);
+                ctx->finished = true;
+                ctx->ending.notify_all();
+            } CPP_PTHREAD_CATCH_ALL { //NOSONAR threads cannot throw exceptions when ending.
+                printf("failed to record thread accounting in thread_startup_context()."); //NOSONAR this should never happen
+            }
+
+            if (ctx->group != nullptr) {
+                CPP_PTHREAD_TRY {
+                    pthread::lock_guard<pthread::mutex> lck(ctx->group->mutex);
+                    ctx->group->condition.notify_all();
+                } CPP_PTHREAD_CATCH_ALL { //NOSONAR threads cannot throw exceptions when ending.
+                    printf("failed to notify thread group in thread_startup_context()."); //NOSONAR this should never happen
+                }
+            }
+
+            return nullptr;
+        }
+    }
+
+    namespace this_thread {
+
+        void sleep_for(const int millis) {
+            if ( millis < 0 ){
               std::string message {"sleep_for received an unexpected duration value "};
               message = message + "(" + std::to_string(millis) +")";
-              throw pthread_exception(message);
+              throw_exception(pthread_exception(message));
+            }
+
+            sleep_for(std::chrono::milliseconds(millis));
+        }
+
+        void sleep_for(std::chrono::nanoseconds duration) {
+            if ( duration.count() > 0 ){
+                sleep_until(std::chrono::steady_clock::now() + duration);
+            }
+        }
+
+        void sleep_for(std::chrono::nanoseconds duration, std::chrono::nanoseconds spin) {
+            if ( duration.count() > 0 ){
+                sleep_until(std::chrono::steady_clock::now() + duration, spin);
+            }
+        }
+
+        void sleep_until(std::chrono::steady_clock::time_point deadline) {
+#if defined(_POSIX_CLOCK_SELECTION) && _POSIX_CLOCK_SELECTION > 0 && defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+            // the steady clock is CLOCK_MONOTONIC
+            auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+            if ( since_epoch <= 0 ){
+                return;
+            }
+
+            timespec abstime;
+            abstime.tv_sec = static_cast<time_t>(since_epoch / 1000000000);
+            abstime.tv_nsec = static_cast<long>(since_epoch % 1000000000);
+
+            int rc = 0;
+            while ( (rc = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &abstime, nullptr)) == EINTR ){
+                // interrupted by a signal handler, the deadline doesn't move.
+            }
+            if ( rc != 0 ){
+                throw_exception(pthread_exception("in sleep_until, call to clock_nanosleep failed. ", rc));
+            }
+#else
+            // no clock_nanosleep, sleep for what remains until the deadline is reached.
+            for ( auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now() ){
+                auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+
+                timespec request;
+                request.tv_sec = static_cast<time_t>(remaining / 1000000000);
+                request.tv_nsec = static_cast<long>(remaining % 1000000000);
+
+                if ( nanosleep(&request, nullptr) != 0 && errno != EINTR ){
+                    throw_exception(pthread_exception("in sleep_until, call to nanosleep failed. ", errno));
+                }
+            }
+#endif
+        }
+
+        void sleep_until(std::chrono::steady_clock::time_point deadline, std::chrono::nanoseconds spin) {
+            if ( spin.count() <= 0 ){
+                sleep_until(deadline);
+                return;
+            }
+
+            sleep_until(deadline - spin);
+            while ( std::chrono::steady_clock::now() < deadline ){
+                pause();
             }
         }
 
@@ -46,37 +313,85 @@ namespace pthread {
         if (_thread != 0) {
 
             if (_thread == this_thread::get_id()) {
-                throw thread_exception("join failed, joining yourself would endup in deadlock.");
+                throw_exception(thread_exception("join failed, joining yourself would endup in deadlock."));
             }
 
             if (_status == thread_status::not_a_thread) {
-                throw thread_exception("join failed, this is not a thread.");
+                throw_exception(thread_exception("join failed, this is not a thread."));
+            }
+
+            std::error_code ec;
+            join(ec);
+            switch (ec.value()) {
+                case 0:
+                    break;
+                case EDEADLK:
+                    throw_exception(thread_exception("pthread::thread::join failed because of deadlock conditions.", ec.value()));
+                case EINVAL:
+                    throw_exception(thread_exception("pthread::thread::join failed not a joinable thread.", ec.value()));
+                default:
+                    throw_exception(thread_exception("pthread::thread::join detected an unexpected return code.", ec.value()));
+            }
+        }
+    }
+
+    void thread::join(std::error_code &ec) noexcept {
+        ec.clear();
+
+        if (_thread != 0) {
+
+            if (_thread == this_thread::get_id()) {
+                ec.assign(EDEADLK, std::system_category());
+                return;
+            }
+
+            if (_status == thread_status::not_a_thread) {
+                ec.assign(EINVAL, std::system_category());
+                return;
             }
 
             int rc = pthread_join(_thread, NULL);
-            if (rc == 0) {
-                // thread was successfully joined, it's safe to assume that it's not a thread anymore.
+            if (rc == 0 || rc == ESRCH) {
+                // thread was successfully joined (or has already ended), it's safe to assume that it's not a thread anymore.
                 _status = thread_status::not_a_thread;
                 _thread = 0;
             } else {
-                switch (rc) {
-                    case EDEADLK:
-                        throw thread_exception("pthread::thread::join failed because of deadlock conditions.", rc);
-                    case EINVAL:
-                        throw thread_exception("pthread::thread::join failed not a joinable thread.", rc);
-                    case ESRCH:
-                        break; // thread has already ended.
-                    default:
-                        throw thread_exception("pthread::thread::join detected an unexpected return code.", rc);
-                }
+                ec.assign(rc, std::system_category());
             }
         }
     }
 
+    bool thread::try_join() {
+        return join_for(0);
+    }
+
+    bool thread::join_for(int millis) {
+        if (_thread == 0 || _context == nullptr) {
+            return true;
+        }
+
+        if (_thread == this_thread::get_id()) {
+            throw_exception(thread_exception("join failed, joining yourself would endup in deadlock."));
+        }
+
+        bool finished = false;
+        {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+            finished = _context->finished ||
+                       (millis > 0 && _context->ending.wait_for(_context->mutex, millis, [this] { return _context->finished; }));
+        }
+
+        if (finished) {
+            join(); // the thread has ended, this doesn't block
+        }
+
+        return finished;
+    }
+
     thread::thread() : _thread(0), _attr_ptr{nullptr}, _status(thread_status::not_a_thread) {
         int rc = pthread_attr_init(&_attr);
         if (rc != 0) {
-            throw thread_exception("pthread_attr_init call in pthread::pthread() failed.", rc);
+            throw_exception(thread_exception("pthread_attr_init call in pthread::pthread() failed.", rc));
         } else {
             _attr_ptr = &_attr;
         }
@@ -96,28 +411,44 @@ namespace pthread {
         init (&work, stack_size);
     }
 
-    int thread::init( const runnable *runner, std::size_t stack_size ) {
+    thread::thread(const runnable *work, const std::string &name, std::size_t stack_size) : thread() {
+#ifdef DEBUG
+        std:: cout << "constructor " << __FUNCTION__ << ":  runnable pointer, " << name << ", " << stack_size << " bytes. " << std::endl << std::flush;
+#endif
+        init(work, stack_size, name);
+    }
+
+    thread::thread(const runnable *work, const std::string &name, std::size_t stack_size, const std::shared_ptr<thread_group_context> &group) : thread() {
+        init(work, stack_size, name, group);
+    }
+
+    int thread::init( const runnable *runner, std::size_t stack_size, const std::string &name, const std::shared_ptr<thread_group_context> &group ) {
         int rc = -1; // initial return code value is failed
 
         rc = pthread_attr_setdetachstate(_attr_ptr, PTHREAD_CREATE_JOINABLE);
         if (rc != 0) {
-            throw thread_exception("pthread_attr_setdetachstate failed.", rc);
+            throw_exception(thread_exception("pthread_attr_setdetachstate failed.", rc));
         }
 
         if (stack_size > 0) {
             if ( stack_size > PTHREAD_STACK_MIN) {
                 rc = pthread_attr_setstacksize(_attr_ptr, stack_size);
                 if ((stack_size > 0) && (rc != 0)) {
-                    throw thread_exception("bad stacksize, check size passed to thread::thread, thread not started.", rc);
+                    throw_exception(thread_exception("bad stacksize, check size passed to thread::thread, thread not started.", rc));
                 }
             } else {
-                throw thread_exception(std::string{"minimum stack size is "} + std::to_string(PTHREAD_STACK_MIN) + " bytes, you passed a size of " + std::to_string(stack_size));
+                throw_exception(thread_exception(std::string{"minimum stack size is "} + std::to_string(PTHREAD_STACK_MIN) + " bytes, you passed a size of " + std::to_string(stack_size)));
             }
         }
 
-        rc = pthread_create(&_thread, _attr_ptr, thread_startup_runnable, (void *) runner);
+        _context = std::make_shared<thread_context>(runner, measure_stack_usage(), name, group);
+
+        auto *reference = new std::shared_ptr<thread_context>(_context); // released by thread_startup_context
+        rc = pthread_create(&_thread, _attr_ptr, thread_startup_context, reference);
         if (rc != 0) {
-            throw thread_exception("pthread_create failed.", rc);
+            delete reference;
+            _context.reset();
+            throw_exception(thread_exception("pthread_create failed.", rc));
         } else {
             _status = thread_status::a_thread;
         }
@@ -159,6 +490,7 @@ namespace pthread {
         std::swap(_thread, other._thread);
         std::swap(_status, other._status);
         std::swap(_attr, other._attr);
+        std::swap(_context, other._context);
         _attr_ptr = &_attr; // pthread_attribute is always initialized
     }
 
@@ -166,14 +498,80 @@ namespace pthread {
         size_t size = -1;
         int rc = pthread_attr_getstacksize(_attr_ptr, &size);
         if ( rc != 0 ){
-            throw thread_exception("failed to get stack size.", rc);
+            throw_exception(thread_exception("failed to get stack size.", rc));
         }
         return size;
     }
 
+    std::size_t thread::stack_usage() const {
+        std::size_t usage = 0;
+
+        if (_context != nullptr && _context->measure_stack) {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+            usage = _context->stack_low == nullptr ? _context->stack_usage : scan_stack(*_context);
+        }
+
+        return usage;
+    }
+
+    bool thread::ended() const {
+        if (_context == nullptr) {
+            return false;
+        }
+
+        pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+        return _context->finished;
+    }
+
+    std::string thread::name() const {
+        return _context != nullptr ? _context->name : std::string{};
+    }
+
+    thread_accounting thread::accounting() const {
+        thread_accounting accounting{name(), std::chrono::nanoseconds(0), std::chrono::nanoseconds(0), 0, 0};
+
+        if (_context != nullptr) {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+
+            if (_context->finished) {
+                accounting.cpu_time = _context->cpu_time;
+                accounting.wall_time = _context->end - _context->start;
+                accounting.voluntary_context_switches = _context->voluntary_context_switches;
+                accounting.involuntary_context_switches = _context->involuntary_context_switches;
+            } else if (_context->started) {
+                clockid_t clock;
+                timespec cpu;
+                int rc = pthread_getcpuclockid(_thread, &clock);
+                if (rc != 0) {
+                    throw_exception(thread_exception("pthread_getcpuclockid failed.", rc));
+                }
+                if (clock_gettime(clock, &cpu) != 0) {
+                    throw_exception(thread_exception("failed to read thread's CPU clock.", errno));
+                }
+
+                accounting.cpu_time = to_nanoseconds(cpu);
+                accounting.wall_time = std::chrono::steady_clock::now() - _context->start;
+                read_context_switches(_context->tid, accounting.voluntary_context_switches, accounting.involuntary_context_switches);
+            }
+        }
+
+        return accounting;
+    }
+
+    void thread::measure_stack_usage(bool enabled) {
+        measure_stacks = enabled;
+    }
+
+    bool thread::measure_stack_usage() {
+        return measure_stacks;
+    }
+
     abstract_thread::abstract_thread(const std::size_t stack_size) : _thread(NULL), _stack_size(stack_size) {
     }
 
+    abstract_thread::abstract_thread(const std::string &name, const std::size_t stack_size) : _thread(NULL), _stack_size(stack_size), _name(name) {
+    }
+
     abstract_thread::~abstract_thread() {
 
         if (_thread != NULL) {
@@ -184,7 +582,16 @@ namespace pthread {
 
     void abstract_thread::start() {
 
-        _thread = new pthread::thread(*this, _stack_size);
+        _thread = new pthread::thread(this, _name, _stack_size);
+    }
+
+    void abstract_thread::start(const std::shared_ptr<thread_group_context> &group) {
+
+        _thread = new pthread::thread(this, _name, _stack_size, group);
+    }
+
+    bool abstract_thread::ended() const {
+        return _thread != nullptr && _thread->ended();
     }
 
     void abstract_thread::join() {
@@ -193,10 +600,40 @@ namespace pthread {
         }
     };
 
+    void abstract_thread::join(std::error_code &ec) noexcept {
+        ec.clear();
+        if ( _thread != nullptr ){
+            _thread->join(ec);
+        }
+    }
+
+    bool abstract_thread::try_join() {
+        return _thread == nullptr || _thread->try_join();
+    }
+
+    bool abstract_thread::join_for(int millis) {
+        return _thread == nullptr || _thread->join_for(millis);
+    }
+
     bool abstract_thread::joinable() const {
         return _thread != nullptr && _thread->joinable();
     };
 
+    std::size_t abstract_thread::stack_size() const {
+        return _thread != nullptr ? _thread->stack_size() : _stack_size;
+    }
+
+    std::size_t abstract_thread::stack_usage() const {
+        return _thread != nullptr ? _thread->stack_usage() : 0;
+    }
+
+    thread_accounting abstract_thread::accounting() const {
+        if (_thread != nullptr) {
+            return _thread->accounting();
+        }
+        return thread_accounting{_name, std::chrono::nanoseconds(0), std::chrono::nanoseconds(0), 0, 0};
+    }
+
 #if __cplusplus < 201103L
     thread_group::thread_group(bool destructor_joins_first) throw():  _destructor_joins_first(destructor_joins_first){
 #else
@@ -218,13 +655,10 @@ namespace pthread {
             _threads.pop_front();
 
             if (_destructor_joins_first && thread->joinable()) {
-                try {
-                    thread->join();
-                } catch (pthread_exception &err) {
-                    std::cerr << "thread_group destructor failed to join one thread. " << err.what() << std::endl << std::flush;
-                } catch (...) { //NOSONAR this was done on purpose to avoid crashes due to unhandled error conditions.
-                                // This should never happen.
-                    std::cerr << "thread_group destructor catched an unexpected exception when joining threads." << std::endl << std::flush;
+                std::error_code error;
+                thread->join(error);
+                if (error) {
+                    std::cerr << "thread_group destructor failed to join one thread. " << error.message() << std::endl << std::flush;
                 }
             }
         }
@@ -235,9 +669,31 @@ namespace pthread {
         _threads.push_back(thread);
     }
 
-    void thread_group::start() {
-        for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
-            (*iterator)->start();
+    void thread_group::start(start_mode mode) {
+        if (_context == nullptr) {
+            _context = std::make_shared<thread_group_context>();
+        }
+
+        if (mode == start_mode::barrier) {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+            _context->released = false;
+        }
+
+        CPP_PTHREAD_TRY {
+            for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+                (*iterator)->start(_context);
+            }
+        } CPP_PTHREAD_CATCH_ALL { //NOSONAR the gate must be opened (threads that were created would wait forever), then the error is passed on.
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+            _context->released = true;
+            _context->condition.notify_all();
+            CPP_PTHREAD_RETHROW;
+        }
+
+        if (mode == start_mode::barrier) {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+            _context->released = true;
+            _context->condition.notify_all();
         }
     }
 
@@ -249,15 +705,126 @@ namespace pthread {
         }
     }
 
+    abstract_thread *thread_group::join_any() {
+        abstract_thread *ended = nullptr;
+
+        if (_context != nullptr) {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+
+            bool running = true;
+            while (ended == nullptr && running) {
+                running = false;
+                for (auto iterator = _threads.begin(); iterator != _threads.end() && ended == nullptr; iterator++) {
+                    if ((*iterator)->joinable()) {
+                        running = true;
+                        if ((*iterator)->ended()) {
+                            ended = *iterator;
+                        }
+                    }
+                }
+
+                if (ended == nullptr && running) {
+                    _context->condition.wait(_context->mutex);
+                }
+            }
+        }
+
+        if (ended != nullptr) {
+            ended->join(); // the thread has ended, this doesn't block
+        }
+
+        return ended;
+    }
+
+    bool thread_group::wait_for_all(int millis) {
+        bool all_ended = true;
+
+        if (_context != nullptr) {
+            pthread::lock_guard<pthread::mutex> lck(_context->mutex);
+
+            all_ended = _context->condition.wait_for(_context->mutex, millis, [this] {
+                for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+                    if ((*iterator)->joinable() && !(*iterator)->ended()) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+        }
+
+        for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+            if ((*iterator)->joinable() && (*iterator)->ended()) {
+                (*iterator)->join();
+            }
+        }
+
+        return all_ended;
+    }
+
+    bool thread_group::try_join() {
+        bool all_joined = true;
+
+        for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+            all_joined = (*iterator)->try_join() && all_joined;
+        }
+
+        return all_joined;
+    }
+
+    bool thread_group::join_for(int millis) {
+        bool all_joined = true;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(millis);
+
+        for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            all_joined = (*iterator)->join_for(remaining > 0 ? static_cast<int>(remaining) : 0) && all_joined;
+        }
+
+        return all_joined;
+    }
+
     unsigned long thread_group::size() {
         return _threads.size();
     }
 
+    stack_usage_summary thread_group::stack_usage() const {
+        stack_usage_summary summary{0, 0, 0, 0, 0};
+        std::size_t total = 0;
+
+        for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+            auto usage = (*iterator)->stack_usage();
+            if (usage > 0) {
+                summary.lowest = summary.threads == 0 ? usage : std::min(summary.lowest, usage);
+                summary.highest = std::max(summary.highest, usage);
+                summary.stack_size = std::max(summary.stack_size, (*iterator)->stack_size());
+                summary.threads++;
+                total += usage;
+            }
+        }
+
+        if (summary.threads > 0) {
+            summary.average = total / summary.threads;
+        }
+
+        return summary;
+    }
+
+    std::vector<thread_accounting> thread_group::accounting() const {
+        std::vector<thread_accounting> accountings;
+        accountings.reserve(_threads.size());
+
+        for (auto iterator = _threads.begin(); iterator != _threads.end(); iterator++) {
+            accountings.push_back((*iterator)->accounting());
+        }
+
+        return accountings;
+    }
+
     void *thread_startup_runnable(void *runner) { // NOSONAR
 
-        try {
+        CPP_PTHREAD_TRY {
             static_cast<runnable *>(runner)->run();
-        } catch (...) { // NOSONAR threads cannot throw exceptions when ending, this prevents this from happening.
+        } CPP_PTHREAD_CATCH_ALL { // NOSONAR threads cannot throw exceptions when ending, this prevents this from happening.
             printf("uncaugth exception in thread_startup_runnable(), check your runnable::run() implementation."); //NOSONAR this should never happen, BUT if it does, I want to be sure to see it
         }
         return nullptr;
@@ -0,0 +1,115 @@
+//
+//  upgradable_lock.cpp
+//  cpp-pthread
+//
+
+#include "pthread/upgradable_lock.hpp"
+#include "pthread/lock_guard.hpp"
+
+namespace pthread {
+
+    // upgradable_read_lock -----------------------------
+    //
+    upgradable_read_lock::upgradable_read_lock() : _readers(0), _writers_waiting(0), _upgrader(false), _writer(false) {
+    }
+
+    void upgradable_read_lock::lock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        _readers_cv.wait(_mutex, [this] { return readable(); });
+        _readers++;
+    }
+
+    bool upgradable_read_lock::try_lock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        if (!readable()) {
+            return false;
+        }
+
+        _readers++;
+        return true;
+    }
+
+    void upgradable_read_lock::unlock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        if (--_readers == 0) {
+            _writers_cv.notify_all(); // a writer or the promoting upgrader
+        }
+    }
+
+    // upgrade_lock -----------------------------
+    //
+    void upgrade_lock::lock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        _readers_cv.wait(_mutex, [this] { return readable() && !_upgrader; });
+        _upgrader = true;
+    }
+
+    bool upgrade_lock::try_lock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        if (!readable() || _upgrader) {
+            return false;
+        }
+
+        _upgrader = true;
+        return true;
+    }
+
+    void upgrade_lock::unlock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        _upgrader = false;
+        _writer = false; // the upgrade lock was promoted
+        _readers_cv.notify_all();
+        _writers_cv.notify_all();
+    }
+
+    void upgrade_lock::promote() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        if (!_upgrader || _writer) {
+            throw_exception(read_write_lock_exception("promote() needs a (not yet promoted) upgrade lock.", EPERM));
+        }
+
+        // writers wait for the upgrader, only the readers must leave.
+        _writers_waiting++;
+        _writers_cv.wait(_mutex, [this] { return _readers == 0; });
+        _writers_waiting--;
+        _writer = true;
+    }
+
+    void upgrade_lock::demote() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        if (!_upgrader || !_writer) {
+            throw_exception(read_write_lock_exception("demote() needs a promoted upgrade lock.", EPERM));
+        }
+
+        _writer = false;
+        _readers_cv.notify_all();
+    }
+
+    // upgradable_write_lock -----------------------------
+    //
+    void upgradable_write_lock::lock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        _writers_waiting++;
+        _writers_cv.wait(_mutex, [this] { return !_writer && !_upgrader && _readers == 0; });
+        _writers_waiting--;
+        _writer = true;
+    }
+
+    bool upgradable_write_lock::try_lock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        if (_writer || _upgrader || _readers != 0) {
+            return false;
+        }
+
+        _writer = true;
+        return true;
+    }
+
+    void upgradable_write_lock::unlock() {
+        pthread::lock_guard<pthread::mutex> lock(_mutex);
+        _writer = false;
+        _readers_cv.notify_all();
+        _writers_cv.notify_all();
+    }
+
+} // namespace pthread
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <vector>
 #include <ctime>
 #include <chrono>
 
@@ -99,4 +100,161 @@ TEST(abstract_thread_group, start_join) {
 
     threads.start();
     threads.join();
-}
\ No newline at end of file
+}
+
+TEST(abstract_thread_group, stack_usage) {
+    pthread::thread_group threads;
+
+    for (auto x = 3; x > 0; x--) {
+        threads.add(new test_thread{});
+    }
+
+    pthread::thread::measure_stack_usage(true);
+    threads.start();
+    pthread::thread::measure_stack_usage(false);
+    threads.join();
+
+    auto summary = threads.stack_usage();
+    std::cout << "stack usage: lowest " << summary.lowest << ", highest " << summary.highest << ", average " << summary.average
+              << " of " << summary.stack_size << " bytes" << std::endl;
+
+    EXPECT_EQ(summary.threads, 3);
+    EXPECT_GT(summary.lowest, 0);
+    EXPECT_LE(summary.lowest, summary.average);
+    EXPECT_LE(summary.average, summary.highest);
+    EXPECT_LT(summary.highest, summary.stack_size);
+}
+
+TEST(abstract_thread_group, accounting) {
+    class named_thread : public pthread::abstract_thread {
+    public:
+        explicit named_thread(const std::string &name) : abstract_thread(name) {
+        }
+
+        void run() noexcept override {
+            pthread::this_thread::sleep_for(100);
+        }
+    };
+
+    pthread::thread_group threads;
+    threads.add(new named_thread{"worker-1"});
+    threads.add(new named_thread{"worker-2"});
+
+    threads.start();
+    auto running = threads.accounting(); // read while the threads are (most likely) running
+    threads.join();
+    auto ended = threads.accounting();
+
+    ASSERT_EQ(running.size(), 2);
+    ASSERT_EQ(ended.size(), 2);
+    EXPECT_EQ(ended[0].name, "worker-1");
+    EXPECT_EQ(ended[1].name, "worker-2");
+
+    for (auto accounting : ended) {
+        EXPECT_GE(accounting.wall_time, std::chrono::milliseconds(100));
+        EXPECT_LT(accounting.cpu_time, accounting.wall_time);
+    }
+}
+
+class sleeping_thread : public pthread::abstract_thread {
+public:
+    explicit sleeping_thread(int millis, const std::vector<sleeping_thread *> *siblings = nullptr) : _millis(millis), _siblings(siblings), _existing_siblings(0) {
+    }
+
+    void run() noexcept override {
+        if (_siblings != nullptr) {
+            for (auto sibling : *_siblings) {
+                _existing_siblings += sibling->joinable() ? 1 : 0;
+            }
+        }
+        pthread::this_thread::sleep_for(_millis);
+    }
+
+    /** @return number of sibling threads that were already created when this thread started running. */
+    int existing_siblings() const {
+        return _existing_siblings;
+    }
+
+private:
+    int _millis;
+    const std::vector<sleeping_thread *> *_siblings;
+    int _existing_siblings;
+};
+
+TEST(abstract_thread_group, barrier_start) {
+    pthread::thread_group threads;
+    std::vector<sleeping_thread *> sleepers;
+
+    for (auto x = 10; x > 0; x--) {
+        sleepers.push_back(new sleeping_thread{10, &sleepers});
+        threads.add(sleepers.back());
+    }
+
+    threads.start(pthread::start_mode::barrier);
+    EXPECT_TRUE(threads.wait_for_all(2000));
+
+    for (auto sleeper : sleepers) {
+        EXPECT_EQ(sleeper->existing_siblings(), 10); // no thread ran before all were created
+        EXPECT_FALSE(sleeper->joinable());
+    }
+}
+
+TEST(abstract_thread_group, join_any) {
+    pthread::thread_group threads;
+
+    auto slow = new sleeping_thread{600};
+    auto fast = new sleeping_thread{100};
+    auto medium = new sleeping_thread{300};
+    threads.add(slow);
+    threads.add(fast);
+    threads.add(medium);
+
+    EXPECT_EQ(threads.join_any(), nullptr); // nothing was started
+
+    threads.start();
+
+    EXPECT_EQ(threads.join_any(), fast);
+    EXPECT_EQ(threads.join_any(), medium);
+    EXPECT_EQ(threads.join_any(), slow);
+    EXPECT_EQ(threads.join_any(), nullptr);
+}
+
+TEST(abstract_thread_group, wait_for_all) {
+    pthread::thread_group threads;
+
+    auto slow = new sleeping_thread{500};
+    auto fast = new sleeping_thread{10};
+    threads.add(slow);
+    threads.add(fast);
+    threads.start();
+
+    EXPECT_FALSE(threads.wait_for_all(200));
+    EXPECT_FALSE(fast->joinable()); // ended threads were joined
+    EXPECT_TRUE(slow->joinable());
+
+    EXPECT_TRUE(threads.wait_for_all(2000));
+    EXPECT_FALSE(slow->joinable());
+}
+
+TEST(abstract_thread_group, try_join_and_join_for) {
+    pthread::thread_group threads;
+
+    auto slow = new sleeping_thread{500};
+    auto fast = new sleeping_thread{10};
+    threads.add(slow);
+    threads.add(fast);
+
+    EXPECT_TRUE(slow->try_join()); // not started, nothing to join
+
+    slow->start(); // not started by the group
+    fast->start();
+    pthread::this_thread::sleep_for(100);
+
+    EXPECT_FALSE(threads.try_join());
+    EXPECT_FALSE(fast->joinable());
+    EXPECT_FALSE(slow->join_for(10));
+
+    EXPECT_FALSE(threads.join_for(100));
+    EXPECT_TRUE(threads.join_for(2000));
+    EXPECT_FALSE(slow->joinable());
+}
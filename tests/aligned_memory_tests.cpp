@@ -0,0 +1,64 @@
+//
+// aligned_memory_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    struct alignas(64) padded {
+        std::atomic<std::uint32_t> value;
+    };
+
+    int alive = 0; // constructed and not yet destroyed throwing instances
+
+    /** the fourth instance can't be constructed. */
+    struct throwing {
+        throwing() {
+            if (alive == 3) {
+                throw std::runtime_error("fourth instance");
+            }
+            alive++;
+        }
+
+        ~throwing() {
+            alive--;
+        }
+    };
+}
+
+TEST(aligned_memory, alignment) {
+    std::vector<padded *> allocated;
+    for (std::size_t count = 1; count <= 50; count++) {
+        padded *items = pthread::util::aligned_new<padded>(count);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(items) % 64, 0u);
+        EXPECT_EQ(items[count - 1].value.load(), 0u);
+        allocated.push_back(items);
+    }
+
+    for (std::size_t index = 0; index < allocated.size(); index++) {
+        pthread::util::aligned_delete(allocated[index], index + 1);
+    }
+    pthread::util::aligned_delete<padded>(nullptr);
+}
+
+TEST(aligned_memory, throwing_constructor) {
+    EXPECT_THROW(pthread::util::aligned_new<throwing>(5), std::runtime_error);
+    EXPECT_EQ(alive, 0); // the instances built before the exception were destroyed
+
+    throwing *items = pthread::util::aligned_new<throwing>(3);
+    EXPECT_EQ(alive, 3);
+    pthread::util::aligned_delete(items, 3);
+    EXPECT_EQ(alive, 0);
+}
+
+TEST(aligned_memory, overflow) {
+    EXPECT_THROW(pthread::util::aligned_new<padded>(SIZE_MAX / sizeof(padded) + 1), pthread::pthread_exception);
+}
@@ -0,0 +1,133 @@
+//
+// big_reader_lock_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+TEST(big_reader_lock, lock_try_lock_unlock) {
+    pthread::big_reader_lock rwlock;
+    pthread::big_reader_read_lock &reader = rwlock;
+
+    EXPECT_GE(rwlock.slots(), 1u);
+    EXPECT_EQ(rwlock.slots() & (rwlock.slots() - 1), 0u); // power of 2
+
+    EXPECT_TRUE(reader.try_lock());
+    EXPECT_TRUE(reader.try_lock()); // readers share the lock
+    EXPECT_FALSE(rwlock.try_lock());
+    reader.unlock();
+    reader.unlock();
+
+    EXPECT_TRUE(rwlock.try_lock());
+    EXPECT_FALSE(reader.try_lock());
+    EXPECT_FALSE(rwlock.try_lock());
+    rwlock.unlock();
+
+    {
+        pthread::lock_guard<pthread::big_reader_write_lock> lock(rwlock);
+        EXPECT_FALSE(reader.try_lock());
+    }
+    {
+        pthread::lock_guard<pthread::big_reader_read_lock> lock(rwlock);
+        EXPECT_FALSE(rwlock.try_lock());
+    }
+    EXPECT_TRUE(rwlock.try_lock());
+    rwlock.unlock();
+}
+
+TEST(big_reader_lock, reader_waits_for_writer) {
+
+    class reader : public pthread::abstract_thread {
+    public:
+        reader(pthread::big_reader_lock &rwlock, const int &value) : _rwlock(rwlock), _value(value), _read(0) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::big_reader_read_lock> lock(_rwlock);
+            _read = _value;
+        }
+
+        int read() const {
+            return _read;
+        }
+
+    private:
+        pthread::big_reader_lock &_rwlock;
+        const int &_value;
+        int _read;
+    };
+
+    pthread::big_reader_lock rwlock;
+    int value = 0;
+
+    reader thread{rwlock, value};
+    {
+        pthread::lock_guard<pthread::big_reader_write_lock> lock(rwlock);
+        thread.start();
+        pthread::this_thread::sleep_for(50); // the reader waits for the writer
+        value = 42;
+    }
+    thread.join();
+
+    EXPECT_EQ(thread.read(), 42);
+}
+
+TEST(big_reader_lock, readers_and_writers) {
+
+    struct balances {
+        pthread::big_reader_lock rwlock;
+        long first = 0;
+        long second = 0;
+        bool torn = false;
+    };
+
+    class writer : public pthread::abstract_thread {
+    public:
+        explicit writer(balances &shared) : _shared(shared) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 5000; count++) {
+                pthread::lock_guard<pthread::big_reader_write_lock> lock(_shared.rwlock);
+                _shared.first++;
+                _shared.second++;
+            }
+        }
+
+    private:
+        balances &_shared;
+    };
+
+    class reader : public pthread::abstract_thread {
+    public:
+        explicit reader(balances &shared) : _shared(shared) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 20000; count++) {
+                pthread::lock_guard<pthread::big_reader_read_lock> lock(_shared.rwlock);
+                if (_shared.first != _shared.second) {
+                    _shared.torn = true;
+                }
+            }
+        }
+
+    private:
+        balances &_shared;
+    };
+
+    balances shared;
+    pthread::thread_group threads;
+    for (auto x = 0; x < 2; x++) {
+        threads.add(new writer{shared});
+        threads.add(new reader{shared});
+        threads.add(new reader{shared});
+    }
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(shared.first, 2 * 5000);
+    EXPECT_EQ(shared.second, 2 * 5000);
+    EXPECT_FALSE(shared.torn);
+}
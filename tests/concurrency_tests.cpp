@@ -9,6 +9,16 @@
 #include <string>
 #include <memory>
 #include <ctime>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <fstream>
+#include <sstream>
+
+#if !defined(GTEST_SKIP)
+// GoogleTest < 1.10 can't report skipped tests, the message is recorded as a success.
+#define GTEST_SKIP() return GTEST_SUCCEED()
+#endif
 
 class concurrency_test_runnable : public pthread::abstract_thread {
 public:
@@ -56,6 +66,347 @@ TEST(concurrency, mutex) {
     mtr.join();
 }
 
+TEST(concurrency, mutex_attributes) {
+
+    pthread::mutex recursive{pthread::mutex_attributes().type(pthread::mutex_type::recursive)};
+    {
+        pthread::lock_guard<pthread::mutex> lock{recursive};
+        pthread::lock_guard<pthread::mutex> relock{recursive}; // doesn't deadlock
+        EXPECT_TRUE(recursive.try_lock());
+        recursive.unlock();
+    }
+
+    pthread::mutex error_check{pthread::mutex_attributes().type(pthread::mutex_type::error_check)};
+    try {
+        error_check.unlock(); // not the owner
+        FAIL();
+    } catch (const pthread::mutex_exception &err) {
+        EXPECT_EQ(err.error_number(), EPERM);
+    }
+    {
+        pthread::lock_guard<pthread::mutex> lock{error_check};
+        EXPECT_THROW(error_check.lock(), pthread::mutex_exception); // EDEADLK
+    }
+
+#if defined(__GLIBC__)
+    pthread::mutex adaptive{pthread::mutex_attributes().type(pthread::mutex_type::adaptive)};
+    {
+        pthread::lock_guard<pthread::mutex> lock{adaptive};
+        EXPECT_FALSE(adaptive.try_lock());
+    }
+    EXPECT_TRUE(adaptive.try_lock());
+    adaptive.unlock();
+#endif
+}
+
+#if defined(_POSIX_THREAD_ROBUST_PRIO_INHERIT) || defined(_POSIX_THREAD_ROBUST_PRIO_PROTECT)
+TEST(concurrency, robust_mutex) {
+
+    class dying_owner : public pthread::abstract_thread {
+    public:
+        explicit dying_owner(pthread::mutex &mutex) : _mutex(mutex) {
+        }
+
+        void run() noexcept override {
+            _mutex.lock(); // the thread ends without unlocking the mutex
+        }
+
+    private:
+        pthread::mutex &_mutex;
+    };
+
+    pthread::mutex robust{pthread::mutex_attributes().robust()};
+    dying_owner owner{robust};
+    owner.start();
+    owner.join();
+
+    {
+        pthread::lock_guard<pthread::mutex> lock(robust); // doesn't throw, the mutex is locked
+        EXPECT_TRUE(robust.owner_died());
+        robust.consistent();
+        EXPECT_FALSE(robust.owner_died());
+    }
+
+    {
+        pthread::lock_guard<pthread::mutex> lock(robust);
+        EXPECT_FALSE(robust.owner_died());
+    }
+}
+#endif
+
+/** switch the calling thread to SCHED_FIFO.
+ *
+ * @return false if the thread isn't allowed to use a real-time policy.
+ */
+static bool use_fifo_policy(int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+/** @return the real-time priority the calling thread runs at, boosts included (-1 if it can't be read).
+ */
+static int effective_priority() {
+#if defined(__linux__)
+    // the 18th field of /proc/thread-self/stat is the kernel priority, -1 - (effective real-time priority) for SCHED_FIFO
+    std::ifstream stat{"/proc/thread-self/stat"};
+    std::string line;
+    if (std::getline(stat, line) && line.rfind(')') != std::string::npos) {
+        std::istringstream fields{line.substr(line.rfind(')') + 1)};
+        std::string field;
+        for (int index = 3; index <= 18 && fields >> field; index++) {
+            if (index == 18) {
+                return -1 - std::stoi(field);
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+#if defined(_POSIX_THREAD_PRIO_INHERIT) && _POSIX_THREAD_PRIO_INHERIT > 0
+TEST(concurrency, priority_inheritance_mutex) {
+    pthread::priority_inheritance_mutex mutex;
+
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    {
+        pthread::lock_guard<pthread::mutex> lock(mutex);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+
+    pthread::mutex inheriting{pthread::mutex_attributes().type(pthread::mutex_type::recursive).protocol(pthread::mutex_protocol::inherit)};
+    EXPECT_NO_THROW(pthread::lock_guard<pthread::mutex> lock(inheriting));
+
+    /* a low priority thread holds the mutex, a high priority thread waits for it: the owner must run at the waiter's
+     * priority until it releases the mutex. Threads sleep instead of spinning, real-time threads would starve the others.
+     */
+    const int low = sched_get_priority_min(SCHED_FIFO);
+    const int high = low + 10;
+    std::atomic<bool> locked{false};
+    std::atomic<bool> waiting{false};
+    std::atomic<bool> fifo{true};
+
+    class owner_thread : public pthread::abstract_thread {
+    public:
+        owner_thread(pthread::mutex &mutex, int priority, std::atomic<bool> &locked, std::atomic<bool> &waiting, std::atomic<bool> &fifo) :
+                _mutex(mutex), _priority(priority), _locked(locked), _waiting(waiting), _fifo(fifo) {
+        }
+
+        void run() noexcept override {
+            if (!use_fifo_policy(_priority)) {
+                _fifo = false;
+                _locked = true;
+                return;
+            }
+
+            pthread::lock_guard<pthread::mutex> lock(_mutex);
+            unboosted = effective_priority();
+            _locked = true;
+            while (!_waiting) {
+                pthread::this_thread::sleep_for(1);
+            }
+            pthread::this_thread::sleep_for(100); // let the waiter block on the mutex
+            boosted = effective_priority();
+        }
+
+        int unboosted = -1;
+        int boosted = -1;
+
+    private:
+        pthread::mutex &_mutex;
+        int _priority;
+        std::atomic<bool> &_locked;
+        std::atomic<bool> &_waiting;
+        std::atomic<bool> &_fifo;
+    };
+
+    class waiter_thread : public pthread::abstract_thread {
+    public:
+        waiter_thread(pthread::mutex &mutex, int priority, std::atomic<bool> &waiting, std::atomic<bool> &fifo) :
+                _mutex(mutex), _priority(priority), _waiting(waiting), _fifo(fifo) {
+        }
+
+        void run() noexcept override {
+            if (!use_fifo_policy(_priority)) {
+                _fifo = false;
+                _waiting = true;
+                return;
+            }
+
+            _waiting = true;
+            pthread::lock_guard<pthread::mutex> lock(_mutex);
+        }
+
+    private:
+        pthread::mutex &_mutex;
+        int _priority;
+        std::atomic<bool> &_waiting;
+        std::atomic<bool> &_fifo;
+    };
+
+    owner_thread owner{mutex, low, locked, waiting, fifo};
+    waiter_thread waiter{mutex, high, waiting, fifo};
+
+    owner.start();
+    while (!locked) {
+        pthread::this_thread::sleep_for(1);
+    }
+    waiter.start();
+    owner.join();
+    waiter.join();
+
+    if (!fifo || owner.unboosted < 0) {
+        GTEST_SKIP() << "SCHED_FIFO or the thread priorities are not available, priority inheritance not checked";
+    }
+
+    EXPECT_EQ(owner.unboosted, low);
+    EXPECT_EQ(owner.boosted, high);
+}
+#endif
+
+#if defined(_POSIX_THREAD_PRIO_PROTECT) && _POSIX_THREAD_PRIO_PROTECT > 0
+TEST(concurrency, priority_ceiling_mutex) {
+
+    /* locking a priority ceiling mutex requires a real-time scheduling policy (glibc returns EINVAL otherwise), the mutex
+     * is used by a thread which switches to SCHED_FIFO if it's allowed to.
+     */
+    class fifo_thread : public pthread::abstract_thread {
+    public:
+        explicit fifo_thread(pthread::mutex &mutex) : _mutex(mutex) {
+        }
+
+        void run() noexcept override {
+            fifo = use_fifo_policy(sched_get_priority_min(SCHED_FIFO));
+            if (fifo) {
+                try {
+                    pthread::lock_guard<pthread::mutex> lock(_mutex);
+                    locked = true;
+                    priority = effective_priority();
+                    relocked = _mutex.try_lock();
+                } catch (const pthread::mutex_exception &err) {
+                    std::cerr << err.what() << std::endl;
+                }
+            }
+        }
+
+        bool fifo = false;
+        bool locked = false;
+        bool relocked = false;
+        int priority = -1;
+
+    private:
+        pthread::mutex &_mutex;
+    };
+
+    EXPECT_THROW(pthread::priority_ceiling_mutex mutex{-1000}, pthread::mutex_exception);
+
+    const int ceiling = sched_get_priority_max(SCHED_FIFO);
+    pthread::priority_ceiling_mutex mutex{ceiling};
+    fifo_thread thread{mutex};
+    thread.start();
+    thread.join();
+
+    if (!thread.fifo) {
+        GTEST_SKIP() << "not allowed to use SCHED_FIFO, priority_ceiling_mutex not checked";
+    }
+
+    EXPECT_TRUE(thread.locked);
+    EXPECT_FALSE(thread.relocked);
+    if (thread.priority >= 0) {
+        EXPECT_EQ(thread.priority, ceiling); // the owner runs at the ceiling priority
+    }
+}
+#endif
+
+TEST(concurrency, timed_mutex) {
+
+    class holder : public pthread::abstract_thread {
+    public:
+        explicit holder(pthread::timed_mutex &mutex) : _mutex(mutex) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::timed_mutex> lock(_mutex);
+            pthread::this_thread::sleep_for(300);
+        }
+
+    private:
+        pthread::timed_mutex &_mutex;
+    };
+
+    pthread::timed_mutex mutex;
+
+    EXPECT_TRUE(mutex.try_lock_for(10));
+    mutex.unlock();
+
+    holder thread{mutex};
+    thread.start();
+    pthread::this_thread::sleep_for(50); // let the thread lock the mutex
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(mutex.try_lock_for(50));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    EXPECT_FALSE(mutex.try_lock_until(std::chrono::steady_clock::now() - std::chrono::seconds(1))); // deadline already reached
+
+    EXPECT_TRUE(mutex.try_lock_until(std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+    mutex.unlock();
+
+    thread.join();
+}
+
+TEST(concurrency, error_code_api) {
+    std::error_code ec;
+
+    pthread::mutex checked{pthread::mutex_attributes().type(pthread::mutex_type::error_check)};
+    checked.unlock(ec); // not the owner
+    EXPECT_EQ(ec.value(), EPERM);
+    EXPECT_EQ(ec, std::errc::operation_not_permitted);
+
+    checked.lock(ec);
+    EXPECT_FALSE(ec);
+    checked.lock(ec); // relocking an error checking mutex
+    EXPECT_EQ(ec.value(), EDEADLK);
+    EXPECT_FALSE(checked.try_lock(ec)); // busy is not an error
+    EXPECT_FALSE(ec);
+    checked.unlock(ec);
+    EXPECT_FALSE(ec);
+
+    pthread::timed_mutex timed;
+    EXPECT_TRUE(timed.try_lock_for(10, ec));
+    EXPECT_FALSE(ec);
+    timed.unlock(ec);
+
+    pthread::condition_variable condition;
+    checked.lock(ec);
+    EXPECT_EQ(condition.wait_for(checked, 10, ec), pthread::timedout);
+    EXPECT_FALSE(ec);
+    checked.unlock(ec);
+    condition.notify_one(ec);
+    EXPECT_FALSE(ec);
+    condition.notify_all(ec);
+    EXPECT_FALSE(ec);
+
+    pthread::read_write_lock rwlock;
+    rwlock.lock(ec);
+    EXPECT_FALSE(ec);
+    EXPECT_FALSE(rwlock.try_lock(ec));
+    EXPECT_FALSE(ec);
+    rwlock.unlock(ec);
+    EXPECT_FALSE(ec);
+    pthread::read_lock &reader = rwlock;
+    EXPECT_TRUE(reader.try_lock(ec));
+    EXPECT_FALSE(ec);
+    reader.unlock(ec);
+    EXPECT_FALSE(ec);
+
+    pthread::thread not_a_thread;
+    not_a_thread.join(ec);
+    EXPECT_FALSE(ec);
+}
+
 TEST(concurrency, read_write_lock) {
     bool success = false;
 
@@ -90,16 +441,41 @@ TEST(concurrency, read_write_lock) {
     EXPECT_TRUE(success);
 }
 
+TEST(concurrency, read_lock_destructors) {
+    // read/write locks can't be deleted through their read side, which destructor isn't virtual
+    static_assert(!std::is_destructible<pthread::read_lock>::value, "read_lock destructor must be protected");
+    static_assert(!std::is_destructible<pthread::big_reader_read_lock>::value, "big_reader_read_lock destructor must be protected");
+    static_assert(!std::is_destructible<pthread::phase_fair_read_lock>::value, "phase_fair_read_lock destructor must be protected");
+    static_assert(!std::is_destructible<pthread::upgradable_read_lock>::value, "upgradable_read_lock destructor must be protected");
+    static_assert(!std::is_destructible<pthread::upgrade_lock>::value, "upgrade_lock destructor must be protected");
+    static_assert(!std::is_destructible<pthread::profiled_read_lock>::value, "profiled_read_lock destructor must be protected");
+
+    EXPECT_TRUE(std::is_destructible<pthread::read_write_lock>::value);
+    EXPECT_TRUE(std::is_destructible<pthread::big_reader_lock>::value);
+    EXPECT_TRUE(std::is_destructible<pthread::phase_fair_read_write_lock>::value);
+    EXPECT_TRUE(std::is_destructible<pthread::upgradable_read_write_lock>::value);
+    EXPECT_TRUE(std::is_destructible<pthread::profiled_read_write_lock>::value);
+}
+
 TEST(concurrency, try_read_write_lock) {
     bool success = false;
 
     try {
 
         pthread::read_write_lock rwlock;
+        pthread::read_lock &reader = rwlock;
 
-        rwlock.try_lock();
+        EXPECT_TRUE(rwlock.try_lock());
+        EXPECT_FALSE(rwlock.try_lock()); // busy is not an error
+        EXPECT_FALSE(reader.try_lock());
         rwlock.unlock();
 
+        EXPECT_TRUE(reader.try_lock());
+        EXPECT_TRUE(reader.try_lock()); // readers share the lock
+        EXPECT_FALSE(rwlock.try_lock());
+        reader.unlock();
+        reader.unlock();
+
         success = true;
 
     } catch (const std::exception &err) {
@@ -109,6 +485,89 @@ TEST(concurrency, try_read_write_lock) {
     EXPECT_TRUE(success);
 }
 
+TEST(concurrency, timed_read_write_lock) {
+
+    class writer : public pthread::abstract_thread {
+    public:
+        explicit writer(pthread::read_write_lock &rwlock) : _rwlock(rwlock) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::write_lock> lock(_rwlock);
+            pthread::this_thread::sleep_for(300);
+        }
+
+    private:
+        pthread::read_write_lock &_rwlock;
+    };
+
+    pthread::read_write_lock rwlock;
+    pthread::read_lock &reader = rwlock;
+
+    EXPECT_TRUE(reader.try_lock_for(10));
+    EXPECT_FALSE(rwlock.try_lock_for(10)); // a reader holds the lock
+    reader.unlock();
+
+    writer thread{rwlock};
+    thread.start();
+    pthread::this_thread::sleep_for(50); // let the thread lock the rwlock
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(reader.try_lock_for(50));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    std::error_code ec;
+    EXPECT_FALSE(rwlock.try_lock_until(std::chrono::steady_clock::now() - std::chrono::seconds(1), ec)); // deadline already reached
+    EXPECT_FALSE(ec);
+
+    EXPECT_TRUE(reader.try_lock_until(std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+    reader.unlock();
+
+    thread.join();
+}
+
+TEST(concurrency, read_write_lock_policy) {
+
+    class writer : public pthread::abstract_thread {
+    public:
+        explicit writer(pthread::read_write_lock &rwlock) : _rwlock(rwlock) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::write_lock> lock(_rwlock);
+        }
+
+    private:
+        pthread::read_write_lock &_rwlock;
+    };
+
+    for (auto policy: {pthread::rwlock_policy::prefer_readers, pthread::rwlock_policy::prefer_writers}) {
+        pthread::read_write_lock rwlock{policy};
+        pthread::read_lock &reader = rwlock;
+
+        reader.lock();
+        writer thread{rwlock};
+        thread.start();
+        pthread::this_thread::sleep_for(50); // let the writer wait for the lock
+
+        // a new reader doesn't get the lock when writers are preferred
+        bool shared = reader.try_lock();
+        EXPECT_EQ(shared, policy == pthread::rwlock_policy::prefer_readers);
+        if (shared) {
+            reader.unlock();
+        }
+
+        reader.unlock();
+        thread.join();
+    }
+
+    pthread::profiled_read_write_lock named{"prefer writers", pthread::rwlock_policy::prefer_writers};
+    {
+        pthread::lock_guard<pthread::profiled_write_lock> lock(named);
+    }
+    EXPECT_EQ(named.profile().statistics().acquisitions, 1u);
+}
+
 TEST(concurrency, condition_variable_wait_for) {
     pthread::condition_variable condition;
     pthread::mutex mutex;
@@ -130,6 +589,13 @@ TEST(concurrency, condition_variable_wait_for) {
         EXPECT_EQ(pthread::cv_status::timedout, condition.wait_for(lock, 1 * 1000));
     }
 
+    {
+        pthread::lock_guard<pthread::mutex> lock{mutex};
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(pthread::cv_status::timedout, condition.wait_for(lock, -1)); // times out at once
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+    }
+
     {
         pthread::lock_guard<pthread::mutex> lock{mutex};
         EXPECT_EQ(true, condition.wait_for(lock, 1 * 1000, [stop_waiting] {
@@ -153,6 +619,118 @@ TEST(concurrency, condition_variable_wait_for) {
     }
 }
 
+TEST(concurrency, condition_variable_wait_until) {
+    pthread::condition_variable condition;
+    pthread::mutex mutex;
+
+    {
+        pthread::lock_guard<pthread::mutex> lock{mutex};
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+        EXPECT_EQ(pthread::cv_status::timedout, condition.wait_until(lock, deadline));
+        EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+
+        // waiting again for a deadline that is reached doesn't wait
+        EXPECT_EQ(pthread::cv_status::timedout, condition.wait_until(lock, deadline));
+        EXPECT_FALSE(condition.wait_until(lock, deadline, [] { return false; }));
+        EXPECT_TRUE(condition.wait_until(lock, deadline, [] { return true; }));
+
+        std::error_code ec;
+        EXPECT_EQ(pthread::cv_status::timedout, condition.wait_until(mutex, deadline, ec));
+        EXPECT_FALSE(ec);
+    }
+
+    pthread::unique_lock<pthread::mutex> lock{mutex};
+    EXPECT_EQ(pthread::cv_status::timedout, condition.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+}
+
+TEST(concurrency, condition_variable_chrono) {
+    pthread::condition_variable condition;
+    pthread::mutex mutex;
+
+    pthread::unique_lock<pthread::mutex> lock{mutex};
+
+    auto since = std::chrono::steady_clock::now();
+    EXPECT_EQ(pthread::cv_status::timedout, condition.wait_for(lock, std::chrono::microseconds(200)));
+    EXPECT_GE(std::chrono::steady_clock::now() - since, std::chrono::microseconds(200));
+
+    since = std::chrono::steady_clock::now();
+    EXPECT_FALSE(condition.wait_for(lock, std::chrono::microseconds(500), [] { return false; }));
+    EXPECT_GE(std::chrono::steady_clock::now() - since, std::chrono::microseconds(500));
+
+    std::error_code ec;
+    EXPECT_EQ(pthread::cv_status::timedout, condition.wait_for(mutex, std::chrono::microseconds(50), ec));
+    EXPECT_FALSE(ec);
+
+    // other clocks are converted to the steady clock
+    auto deadline = std::chrono::system_clock::now() + std::chrono::milliseconds(2);
+    EXPECT_EQ(pthread::cv_status::timedout, condition.wait_until(mutex, deadline));
+    EXPECT_GE(std::chrono::system_clock::now(), deadline);
+    EXPECT_TRUE(condition.wait_until(lock, std::chrono::system_clock::now(), [] { return true; }));
+    lock.unlock();
+
+    pthread::timed_mutex timed;
+    EXPECT_TRUE(timed.try_lock_for(std::chrono::microseconds(100)));
+    EXPECT_FALSE(timed.try_lock_until(std::chrono::system_clock::now() + std::chrono::microseconds(100)));
+    timed.unlock();
+
+    pthread::read_write_lock rwlock;
+    pthread::read_lock &reader = rwlock;
+    EXPECT_TRUE(rwlock.try_lock_for(std::chrono::microseconds(100)));
+    rwlock.unlock();
+    EXPECT_TRUE(reader.try_lock_for(std::chrono::microseconds(100), ec));
+    EXPECT_FALSE(ec);
+    reader.unlock();
+}
+
+TEST(concurrency, condition_variable_concurrent_timeouts) {
+
+    /* each waiter has its own deadline, the waiters share the condition and are woken up (spuriously) every 10ms. */
+    class waiter : public pthread::abstract_thread {
+    public:
+        waiter(pthread::condition_variable &condition, pthread::mutex &mutex, int millis) : _condition(condition), _mutex(mutex), _millis(millis), _waited(0) {
+        }
+
+        void run() noexcept override {
+            auto since = std::chrono::steady_clock::now();
+            {
+                pthread::lock_guard<pthread::mutex> lock{_mutex};
+                _condition.wait_for(lock, _millis, [] { return false; });
+            }
+            _waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+        }
+
+        long waited() const {
+            return _waited;
+        }
+
+    private:
+        pthread::condition_variable &_condition;
+        pthread::mutex &_mutex;
+        int _millis;
+        std::atomic<long> _waited;
+    };
+
+    pthread::condition_variable condition;
+    pthread::mutex mutex;
+
+    waiter shortest{condition, mutex, 100};
+    waiter longest{condition, mutex, 400};
+    longest.start();
+    shortest.start();
+
+    for (int count = 0; count < 50; count++) {
+        pthread::this_thread::sleep_for(10);
+        condition.notify_all();
+    }
+
+    shortest.join();
+    longest.join();
+
+    EXPECT_GE(shortest.waited(), 100);
+    EXPECT_LT(shortest.waited(), 400);
+    EXPECT_GE(longest.waited(), 400);
+}
+
 /* NOSONAR for later use
    class test_thread: public pthread::abstract_thread{
     public:
@@ -0,0 +1,129 @@
+//
+// futex_mutex_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <chrono>
+
+#if defined(CPP_PTHREAD_HAVE_FUTEX)
+
+class incrementing_thread : public pthread::abstract_thread {
+public:
+
+    incrementing_thread(pthread::futex_mutex &mutex, long &counter) : _mutex(mutex), _counter(counter) {
+    }
+
+    void run() noexcept override {
+        for (auto count = 100000; count > 0; count--) {
+            pthread::lock_guard<pthread::futex_mutex> lck(_mutex);
+            _counter++;
+        }
+    }
+
+private:
+    pthread::futex_mutex &_mutex;
+    long &_counter;
+};
+
+TEST(futex_mutex, size) {
+    EXPECT_EQ(sizeof(pthread::futex_mutex), 4);
+    EXPECT_EQ(sizeof(pthread::futex_condition_variable), 4);
+}
+
+TEST(futex_mutex, lock_try_lock_unlock) {
+    pthread::futex_mutex mutex;
+
+    EXPECT_TRUE(mutex.try_lock());
+    EXPECT_FALSE(mutex.try_lock());
+    mutex.unlock();
+
+    {
+        pthread::lock_guard<pthread::futex_mutex> lck(mutex);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST(futex_mutex, contention) {
+    pthread::futex_mutex mutex;
+    long counter = 0;
+
+    pthread::thread_group threads;
+    for (auto x = 4; x > 0; x--) {
+        threads.add(new incrementing_thread{mutex, counter});
+    }
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(counter, 400000);
+}
+
+TEST(futex_condition_variable, wait_for) {
+    pthread::futex_mutex mutex;
+    pthread::futex_condition_variable condition;
+
+    pthread::lock_guard<pthread::futex_mutex> lck(mutex);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(condition.wait_for(mutex, 100), pthread::cv_status::timedout);
+    EXPECT_FALSE(mutex.try_lock()); // mutex is locked again on return
+    EXPECT_FALSE(condition.wait_for(mutex, 100, [] { return false; }));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+
+    EXPECT_TRUE(condition.wait_for(mutex, 100, [] { return true; }));
+}
+
+TEST(futex_condition_variable, producer_consumer) {
+
+    class consumer : public pthread::abstract_thread {
+    public:
+        consumer(pthread::futex_mutex &mutex, pthread::futex_condition_variable &condition, int &items, int &consumed) :
+                _mutex(mutex), _condition(condition), _items(items), _consumed(consumed) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 1000; count > 0; count--) {
+                pthread::lock_guard<pthread::futex_mutex> lck(_mutex);
+                _condition.wait(_mutex, [this] { return _items > 0; });
+                _items--;
+                _consumed++;
+                _condition.notify_all();
+            }
+        }
+
+    private:
+        pthread::futex_mutex &_mutex;
+        pthread::futex_condition_variable &_condition;
+        int &_items;
+        int &_consumed;
+    };
+
+    pthread::futex_mutex mutex;
+    pthread::futex_condition_variable condition;
+    int items = 0;
+    int consumed = 0;
+
+    pthread::thread_group threads;
+    threads.add(new consumer{mutex, condition, items, consumed});
+    threads.add(new consumer{mutex, condition, items, consumed});
+    threads.start();
+
+    for (auto count = 2000; count > 0; count--) {
+        pthread::lock_guard<pthread::futex_mutex> lck(mutex);
+        condition.wait(mutex, [&items] { return items < 10; });
+        items++;
+        condition.notify_one();
+    }
+
+    EXPECT_TRUE(threads.wait_for_all(10 * 1000));
+    EXPECT_EQ(consumed, 2000);
+    EXPECT_EQ(items, 0);
+}
+
+#endif
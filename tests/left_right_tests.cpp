@@ -0,0 +1,90 @@
+//
+// left_right_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <map>
+
+typedef std::map<int, int> lookup_map;
+
+TEST(left_right, read_modify) {
+    pthread::left_right<lookup_map> map{lookup_map{{1, 10}}};
+
+    EXPECT_EQ(map.read([](const lookup_map &values) { return values.at(1); }), 10);
+
+    int calls = 0;
+    map.modify([&calls](lookup_map &values) {
+        calls++;
+        values[2] = 20;
+    });
+    EXPECT_EQ(calls, 2); // applied to both copies
+
+    EXPECT_EQ(map.read([](const lookup_map &values) { return values.size(); }), 2u);
+    map.modify([](lookup_map &values) { values.erase(1); });
+    EXPECT_EQ(map.read([](const lookup_map &values) { return values.count(1); }), 0u);
+
+    bool visited = false;
+    map.read([&visited](const lookup_map &values) { visited = values.at(2) == 20; }); // void reader
+    EXPECT_TRUE(visited);
+}
+
+TEST(left_right, readers_and_writers) {
+
+    class writer : public pthread::abstract_thread {
+    public:
+        writer(pthread::left_right<lookup_map> &map, int first) : _map(map), _first(first) {
+        }
+
+        void run() noexcept override {
+            for (auto key = _first; key < _first + 500; key++) {
+                _map.modify([key](lookup_map &values) {
+                    values[key] = key * 2;
+                    values[-key] = -key * 2; // keys are always inserted in pairs
+                });
+            }
+        }
+
+    private:
+        pthread::left_right<lookup_map> &_map;
+        int _first;
+    };
+
+    class reader : public pthread::abstract_thread {
+    public:
+        reader(pthread::left_right<lookup_map> &map, std::atomic<int> &inconsistent) : _map(map), _inconsistent(inconsistent) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 20000; count++) {
+                bool consistent = _map.read([](const lookup_map &values) {
+                    return values.size() % 2 == 0 && (values.empty() || values.count(-values.begin()->first) == 1);
+                });
+                if (!consistent) {
+                    _inconsistent++;
+                }
+            }
+        }
+
+    private:
+        pthread::left_right<lookup_map> &_map;
+        std::atomic<int> &_inconsistent;
+    };
+
+    pthread::left_right<lookup_map> map;
+    std::atomic<int> inconsistent{0};
+
+    pthread::thread_group threads;
+    threads.add(new writer{map, 1});
+    threads.add(new writer{map, 1001});
+    threads.add(new reader{map, inconsistent});
+    threads.add(new reader{map, inconsistent});
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(inconsistent, 0);
+    EXPECT_EQ(map.read([](const lookup_map &values) { return values.size(); }), 2u * 1000);
+}
@@ -0,0 +1,343 @@
+//
+// lock_benchmarks.cpp
+//
+// Uncontended cost: a single thread locks and unlocks each kind of lock (through a lock_guard), the average cost of a
+// lock/unlock pair is printed in nanoseconds.
+//
+// Contention benchmark: each thread increments a shared counter inside a critical section, the throughput of pthread::mutex,
+// pthread::spin_lock, pthread::ticket_lock and pthread::mcs_lock is measured from 1 thread to the number of online CPUs.
+//
+// Writer latency: reader threads keep a read/write lock read locked (their critical sections overlap), the time a writer
+// waits for the lock is measured for the default policy, rwlock_policy::prefer_writers and the phase fair lock. Readers
+// give up after 2 seconds, a starving writer waits that long.
+//
+// Read scalability: each thread only takes read locks, the throughput of read_write_lock, phase_fair_read_write_lock and
+// big_reader_lock is measured from 1 thread to the number of online CPUs. The seqlock column reads (copies) a 4 words value,
+// the read_write_lock + copy column reads the same value under a read lock.
+//
+// usage: lock_benchmarks [increments per thread] (numbers are only meaningful in a Release build)
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+template<typename Lock>
+class incrementer : public pthread::abstract_thread {
+public:
+
+    incrementer(Lock &lock, volatile long &counter, long increments) : _lock(lock), _counter(counter), _increments(increments) {
+    }
+
+    void run() noexcept override {
+        for (auto count = _increments; count > 0; count--) {
+            pthread::lock_guard<Lock> guard(_lock);
+            _counter = _counter + 1;
+        }
+    }
+
+private:
+    Lock &_lock;
+    volatile long &_counter;
+    long _increments;
+};
+
+/** @return average cost of an uncontended lock/unlock pair in nanoseconds */
+template<typename Lock, typename Guarded = Lock>
+double measure_uncontended(long iterations) {
+    Lock lock;
+    volatile long counter = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto count = iterations; count > 0; count--) {
+        pthread::lock_guard<Guarded> guard(lock);
+        counter = counter + 1;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / iterations;
+}
+
+/** raw pthread mutex, the baseline of the uncontended benchmark. */
+class raw_mutex {
+public:
+    void lock() {
+        pthread_mutex_lock(&_mutex);
+    }
+
+    void unlock() {
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    raw_mutex() {
+        pthread_mutex_init(&_mutex, nullptr);
+    }
+
+    ~raw_mutex() {
+        pthread_mutex_destroy(&_mutex);
+    }
+
+private:
+    pthread_mutex_t _mutex;
+};
+
+void print_uncontended(long iterations) {
+    std::cout << "uncontended lock/unlock pair (ns, " << iterations << " iterations)" << std::endl
+              << std::fixed << std::setprecision(2)
+              << std::setw(24) << "pthread_mutex_t " << std::setw(10) << measure_uncontended<raw_mutex>(iterations) << std::endl
+              << std::setw(24) << "mutex " << std::setw(10) << measure_uncontended<pthread::mutex>(iterations) << std::endl
+              << std::setw(24) << "read_lock " << std::setw(10) << measure_uncontended<pthread::read_write_lock, pthread::read_lock>(iterations) << std::endl
+              << std::setw(24) << "write_lock " << std::setw(10) << measure_uncontended<pthread::read_write_lock, pthread::write_lock>(iterations) << std::endl
+              << std::setw(24) << "mutex (sizeof) " << std::setw(10) << sizeof(pthread::mutex) << std::endl
+              << std::setw(24) << "read_write_lock (sizeof) " << std::setw(10) << sizeof(pthread::read_write_lock) << std::endl
+              << std::endl;
+}
+
+/** hold a read lock, over and over, until the benchmark ends (or the deadline is reached). */
+template<typename ReadLock>
+class reader : public pthread::abstract_thread {
+public:
+
+    reader(ReadLock &lock, std::atomic<bool> &stop, std::chrono::steady_clock::time_point deadline) : _lock(lock), _stop(stop), _deadline(deadline) {
+    }
+
+    void run() noexcept override {
+        while (!_stop.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < _deadline) {
+            pthread::lock_guard<ReadLock> guard(_lock);
+            for (volatile int count = 0; count < 500; count = count + 1) {
+                // read something
+            }
+        }
+    }
+
+private:
+    ReadLock &_lock;
+    std::atomic<bool> &_stop;
+    std::chrono::steady_clock::time_point _deadline;
+};
+
+/** print the average and max time (in microseconds) a writer waits for the lock while readers_count threads read. */
+template<typename ReadLock, typename WriteLock, typename ReadWriteLock>
+void print_writer_latency(const std::string &name, ReadWriteLock &lock, long readers_count, int writes) {
+    std::atomic<bool> stop{false};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+
+    pthread::thread_group readers;
+    for (auto x = readers_count; x > 0; x--) {
+        readers.add(new reader<ReadLock>{lock, stop, deadline});
+    }
+    readers.start(pthread::start_mode::barrier);
+    pthread::this_thread::sleep_for(10); // let the readers fill the lock
+
+    std::chrono::duration<double, std::micro> total{0};
+    std::chrono::duration<double, std::micro> longest{0};
+    for (auto count = writes; count > 0; count--) {
+        auto start = std::chrono::steady_clock::now();
+        {
+            pthread::lock_guard<WriteLock> guard(lock);
+            std::chrono::duration<double, std::micro> waited = std::chrono::steady_clock::now() - start;
+            total += waited;
+            longest = std::max(longest, waited);
+        }
+        pthread::this_thread::sleep_for(1);
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    readers.join();
+
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(24) << name
+              << std::setw(14) << total.count() / writes
+              << std::setw(14) << longest.count() << std::endl;
+}
+
+void print_writer_latencies(long readers_count, int writes) {
+    std::cout << "write lock latency (us, " << readers_count << " readers, " << writes << " writes)" << std::endl
+              << std::setw(24) << "lock"
+              << std::setw(14) << "avg"
+              << std::setw(14) << "max" << std::endl;
+
+    pthread::read_write_lock default_policy;
+    print_writer_latency<pthread::read_lock, pthread::write_lock>("read_write_lock ", default_policy, readers_count, writes);
+
+#if defined(__GLIBC__)
+    pthread::read_write_lock prefer_writers{pthread::rwlock_policy::prefer_writers};
+    print_writer_latency<pthread::read_lock, pthread::write_lock>("prefer_writers ", prefer_writers, readers_count, writes);
+#endif
+
+    pthread::phase_fair_read_write_lock phase_fair;
+    print_writer_latency<pthread::phase_fair_read_lock, pthread::phase_fair_write_lock>("phase_fair ", phase_fair, readers_count, writes);
+
+    std::cout << std::endl;
+}
+
+/** take a read lock over and over. */
+template<typename ReadLock>
+class read_locker : public pthread::abstract_thread {
+public:
+
+    read_locker(ReadLock &lock, long iterations) : _lock(lock), _iterations(iterations) {
+    }
+
+    void run() noexcept override {
+        for (auto count = _iterations; count > 0; count--) {
+            pthread::lock_guard<ReadLock> guard(_lock);
+        }
+    }
+
+private:
+    ReadLock &_lock;
+    long _iterations;
+};
+
+/** @return millions of read lock/unlock pairs per second */
+template<typename ReadWriteLock, typename ReadLock>
+double measure_reads(int threads_count, long iterations) {
+    ReadWriteLock lock;
+
+    pthread::thread_group threads;
+    for (auto x = threads_count; x > 0; x--) {
+        threads.add(new read_locker<ReadLock>{lock, iterations});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return (threads_count * iterations) / elapsed.count() / 1e6;
+}
+
+/** the value read by the seqlock benchmark. */
+struct quote {
+    long values[4];
+};
+
+/** read a quote over and over, either through a seqlock or under a read lock. */
+class quote_reader : public pthread::abstract_thread {
+public:
+
+    quote_reader(pthread::seqlock<quote> *seqlock, pthread::read_write_lock *rwlock, const quote &value, long iterations) :
+            _seqlock(seqlock), _rwlock(rwlock), _value(value), _iterations(iterations) {
+    }
+
+    void run() noexcept override {
+        volatile long sum = 0;
+        for (auto count = _iterations; count > 0; count--) {
+            if (_seqlock != nullptr) {
+                sum = sum + _seqlock->load().values[count & 3];
+            } else {
+                pthread::lock_guard<pthread::read_lock> guard(*_rwlock);
+                quote copy = _value;
+                sum = sum + copy.values[count & 3];
+            }
+        }
+    }
+
+private:
+    pthread::seqlock<quote> *_seqlock;
+    pthread::read_write_lock *_rwlock;
+    const quote &_value;
+    long _iterations;
+};
+
+/** @return millions of quote reads per second */
+double measure_quote_reads(int threads_count, long iterations, bool use_seqlock) {
+    quote value{{1, 2, 3, 4}};
+    pthread::seqlock<quote> seqlock{value};
+    pthread::read_write_lock rwlock;
+
+    pthread::thread_group threads;
+    for (auto x = threads_count; x > 0; x--) {
+        threads.add(new quote_reader{use_seqlock ? &seqlock : nullptr, use_seqlock ? nullptr : &rwlock, value, iterations});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return (threads_count * iterations) / elapsed.count() / 1e6;
+}
+
+/** @return millions of lock/unlock pairs per second */
+template<typename Lock>
+double measure(int threads_count, long increments) {
+    Lock lock;
+    volatile long counter = 0;
+
+    pthread::thread_group threads;
+    for (auto x = threads_count; x > 0; x--) {
+        threads.add(new incrementer<Lock>{lock, counter, increments});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (counter != threads_count * increments) {
+        std::cerr << "lost updates: " << counter << " != " << threads_count * increments << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    return (threads_count * increments) / elapsed.count() / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    long increments = argc > 1 ? std::atol(argv[1]) : 200000;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    print_uncontended(increments * 50);
+    print_writer_latencies(std::max(2L, cpus), 20);
+
+    std::cout << "Mops/s (" << increments << " increments per thread, " << cpus << " CPUs)" << std::endl
+              << std::setw(8) << "threads"
+              << std::setw(12) << "mutex"
+#if defined(_POSIX_SPIN_LOCKS) && _POSIX_SPIN_LOCKS > 0
+              << std::setw(12) << "spin_lock"
+#endif
+              << std::setw(12) << "ticket_lock"
+              << std::setw(12) << "mcs_lock" << std::endl;
+
+    for (int threads = 1; threads <= cpus; threads = (threads * 2 > cpus && threads < cpus) ? cpus : threads * 2) {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << threads
+                  << std::setw(12) << measure<pthread::mutex>(threads, increments)
+#if defined(_POSIX_SPIN_LOCKS) && _POSIX_SPIN_LOCKS > 0
+                  << std::setw(12) << measure<pthread::spin_lock>(threads, increments)
+#endif
+                  << std::setw(12) << measure<pthread::ticket_lock>(threads, increments)
+                  << std::setw(12) << measure<pthread::mcs_lock>(threads, increments) << std::endl;
+    }
+
+    std::cout << std::endl
+              << "read Mops/s (" << increments << " read locks per thread)" << std::endl
+              << std::setw(8) << "threads"
+              << std::setw(18) << "read_write_lock"
+              << std::setw(18) << "phase_fair"
+              << std::setw(18) << "big_reader_lock"
+              << std::setw(24) << "read_write_lock + copy"
+              << std::setw(12) << "seqlock" << std::endl;
+
+    for (int threads = 1; threads <= cpus; threads = (threads * 2 > cpus && threads < cpus) ? cpus : threads * 2) {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << threads
+                  << std::setw(18) << measure_reads<pthread::read_write_lock, pthread::read_lock>(threads, increments)
+                  << std::setw(18) << measure_reads<pthread::phase_fair_read_write_lock, pthread::phase_fair_read_lock>(threads, increments)
+                  << std::setw(18) << measure_reads<pthread::big_reader_lock, pthread::big_reader_read_lock>(threads, increments)
+                  << std::setw(24) << measure_quote_reads(threads, increments, false)
+                  << std::setw(12) << measure_quote_reads(threads, increments, true) << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+//
+// lock_profile_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <sstream>
+
+class holding_thread : public pthread::abstract_thread {
+public:
+
+    explicit holding_thread(pthread::profiled_mutex &mutex) : _mutex(mutex) {
+    }
+
+    void run() noexcept override {
+        pthread::lock_guard<pthread::profiled_mutex> lock(_mutex);
+        pthread::this_thread::sleep_for(200);
+    }
+
+private:
+    pthread::profiled_mutex &_mutex;
+};
+
+std::uint64_t total(const pthread::lock_histogram &histogram) {
+    std::uint64_t count = 0;
+    for (auto value: histogram) {
+        count += value;
+    }
+    return count;
+}
+
+TEST(lock_profile, mutex) {
+    pthread::profiled_mutex mutex{"profiled mutex"};
+    EXPECT_EQ(mutex.profile().name(), "profiled mutex");
+
+    for (auto count = 10; count > 0; count--) {
+        pthread::lock_guard<pthread::profiled_mutex> lock(mutex);
+    }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    auto statistics = mutex.profile().statistics();
+    EXPECT_EQ(statistics.acquisitions, 11);
+    EXPECT_EQ(statistics.contended, 0);
+    EXPECT_EQ(total(statistics.wait_histogram), 11);
+    EXPECT_EQ(total(statistics.hold_histogram), 11);
+
+    holding_thread holder{mutex};
+    holder.start();
+    pthread::this_thread::sleep_for(50); // let the thread lock the mutex
+    {
+        pthread::lock_guard<pthread::profiled_mutex> lock(mutex); // waits ~150ms
+    }
+    holder.join();
+
+    statistics = mutex.profile().statistics();
+    EXPECT_EQ(statistics.acquisitions, 13);
+    EXPECT_EQ(statistics.contended, 1);
+    EXPECT_GE(statistics.max_wait, std::chrono::milliseconds(100));
+    EXPECT_GE(statistics.wait_time, statistics.max_wait);
+    EXPECT_GE(statistics.hold_time, std::chrono::milliseconds(200));
+
+    mutex.profile().reset();
+    EXPECT_EQ(mutex.profile().statistics().acquisitions, 0);
+}
+
+TEST(lock_profile, recursive_mutex) {
+    pthread::profiled_mutex mutex{"recursive mutex", pthread::mutex_attributes().type(pthread::mutex_type::recursive)};
+
+    {
+        pthread::lock_guard<pthread::profiled_mutex> outer(mutex);
+        pthread::this_thread::sleep_for(100);
+        {
+            pthread::lock_guard<pthread::profiled_mutex> inner(mutex);
+        }
+        pthread::this_thread::sleep_for(100);
+    }
+
+    auto statistics = mutex.profile().statistics();
+    EXPECT_EQ(statistics.acquisitions, 2);
+    EXPECT_EQ(total(statistics.hold_histogram), 1); // held once, from the outer lock to its unlock
+    EXPECT_GE(statistics.hold_time, std::chrono::milliseconds(200));
+}
+
+TEST(lock_profile, condition_variable) {
+    pthread::profiled_mutex mutex{"condition mutex"};
+    pthread::condition_variable condition;
+
+    {
+        pthread::lock_guard<pthread::profiled_mutex> lock(mutex);
+        condition.wait_for(mutex, 200); // the mutex is not held while waiting
+    }
+
+    auto statistics = mutex.profile().statistics();
+    EXPECT_EQ(total(statistics.hold_histogram), 2);
+    EXPECT_LT(statistics.hold_time, std::chrono::milliseconds(100));
+}
+
+TEST(lock_profile, read_write_lock) {
+    pthread::profiled_read_write_lock rwlock{"profiled rwlock"};
+
+    {
+        pthread::lock_guard<pthread::profiled_read_lock> lock(rwlock);
+    }
+    {
+        pthread::lock_guard<pthread::profiled_write_lock> lock(rwlock);
+    }
+
+    auto statistics = rwlock.profile().statistics();
+    EXPECT_EQ(statistics.acquisitions, 2);
+    EXPECT_EQ(total(statistics.hold_histogram), 1); // write lock only
+}
+
+TEST(lock_profile, report) {
+    pthread::profiled_mutex quiet{"quiet lock"};
+    pthread::profiled_mutex hot{"hot lock"};
+
+    {
+        pthread::lock_guard<pthread::profiled_mutex> lock(quiet);
+    }
+
+    holding_thread holder{hot};
+    holder.start();
+    pthread::this_thread::sleep_for(50);
+    {
+        pthread::lock_guard<pthread::profiled_mutex> lock(hot);
+    }
+    holder.join();
+
+    {
+        pthread::profiled_mutex destroyed{"destroyed lock"};
+    }
+
+    auto top = pthread::lock_profile::top_contended();
+    ASSERT_EQ(top.size(), 2);
+    EXPECT_EQ(top[0].name, "hot lock");
+    EXPECT_EQ(top[1].name, "quiet lock");
+    EXPECT_EQ(pthread::lock_profile::top_contended(1).size(), 1);
+
+    std::ostringstream report;
+    pthread::lock_profile::report(report);
+    std::cout << report.str();
+    EXPECT_NE(report.str().find("hot lock"), std::string::npos);
+    EXPECT_EQ(report.str().find("destroyed lock"), std::string::npos);
+
+    // the caller's stream formatting is left unchanged
+    std::ostringstream formatted;
+    formatted.precision(5);
+    auto flags = formatted.flags();
+    pthread::lock_profile::report(formatted);
+    EXPECT_EQ(formatted.flags(), flags);
+    EXPECT_EQ(formatted.precision(), 5);
+}
@@ -0,0 +1,140 @@
+//
+// phase_fair_lock_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+TEST(phase_fair_lock, lock_try_lock_unlock) {
+    pthread::phase_fair_read_write_lock rwlock;
+    pthread::phase_fair_read_lock &reader = rwlock;
+
+    EXPECT_TRUE(reader.try_lock());
+    EXPECT_TRUE(reader.try_lock()); // readers share the lock
+    EXPECT_FALSE(rwlock.try_lock());
+    reader.unlock();
+    reader.unlock();
+
+    EXPECT_TRUE(rwlock.try_lock());
+    EXPECT_FALSE(reader.try_lock());
+    EXPECT_FALSE(rwlock.try_lock());
+    rwlock.unlock();
+
+    {
+        pthread::lock_guard<pthread::phase_fair_write_lock> lock(rwlock);
+        EXPECT_FALSE(reader.try_lock());
+    }
+    {
+        pthread::lock_guard<pthread::phase_fair_read_lock> lock(rwlock);
+        EXPECT_FALSE(rwlock.try_lock());
+        EXPECT_TRUE(reader.try_lock());
+        reader.unlock();
+    }
+    EXPECT_TRUE(rwlock.try_lock());
+    rwlock.unlock();
+}
+
+TEST(phase_fair_lock, readers_and_writers) {
+
+    struct balances {
+        pthread::phase_fair_read_write_lock rwlock;
+        long first = 0;
+        long second = 0;
+        bool torn = false;
+    };
+
+    class writer : public pthread::abstract_thread {
+    public:
+        explicit writer(balances &shared) : _shared(shared) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 20000; count++) {
+                pthread::lock_guard<pthread::phase_fair_write_lock> lock(_shared.rwlock);
+                _shared.first++;
+                _shared.second++;
+            }
+        }
+
+    private:
+        balances &_shared;
+    };
+
+    class reader : public pthread::abstract_thread {
+    public:
+        explicit reader(balances &shared) : _shared(shared) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 20000; count++) {
+                pthread::lock_guard<pthread::phase_fair_read_lock> lock(_shared.rwlock);
+                if (_shared.first != _shared.second) {
+                    _shared.torn = true;
+                }
+            }
+        }
+
+    private:
+        balances &_shared;
+    };
+
+    balances shared;
+    pthread::thread_group threads;
+    for (auto x = 0; x < 2; x++) {
+        threads.add(new writer{shared});
+        threads.add(new reader{shared});
+        threads.add(new reader{shared});
+    }
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(shared.first, 2 * 20000);
+    EXPECT_EQ(shared.second, 2 * 20000);
+    EXPECT_FALSE(shared.torn);
+}
+
+TEST(phase_fair_lock, phases_alternate) {
+
+    class ordered_thread : public pthread::abstract_thread {
+    public:
+        ordered_thread(pthread::phase_fair_read_write_lock &rwlock, std::vector<char> &order, char kind) : _rwlock(rwlock), _order(order), _kind(kind) {
+        }
+
+        void run() noexcept override {
+            if (_kind == 'w') {
+                pthread::lock_guard<pthread::phase_fair_write_lock> lock(_rwlock);
+                _order.push_back(_kind);
+            } else {
+                pthread::lock_guard<pthread::phase_fair_read_lock> lock(_rwlock);
+                _order.push_back(_kind); // a single reader per read phase in this test
+            }
+        }
+
+    private:
+        pthread::phase_fair_read_write_lock &_rwlock;
+        std::vector<char> &_order;
+        char _kind;
+    };
+
+    pthread::phase_fair_read_write_lock rwlock;
+    pthread::phase_fair_read_lock &reader = rwlock;
+    std::vector<char> order;
+    pthread::thread_group threads;
+
+    reader.lock(); // read phase
+    for (auto kind: {'w', 'r', 'w'}) {
+        auto thread = new ordered_thread{rwlock, order, kind};
+        threads.add(thread);
+        thread->start();
+        pthread::this_thread::sleep_for(50); // let the thread queue up
+    }
+    EXPECT_FALSE(reader.try_lock()); // a writer is waiting, new readers wait for the next read phase
+    reader.unlock();
+    threads.join();
+
+    // a waiting writer blocks new readers, the reader that arrived during the first write phase enters before the second writer
+    EXPECT_EQ(order, std::vector<char>({'w', 'r', 'w'}));
+}
@@ -0,0 +1,168 @@
+//
+// rcu_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace {
+
+    std::atomic<int> destroyed{0};
+
+    struct tracked {
+        explicit tracked(int value = 0) : value(value) {
+        }
+
+        tracked(const tracked &other) : value(other.value) {
+        }
+
+        ~tracked() {
+            destroyed++;
+        }
+
+        int value;
+    };
+
+    /** hold a read-side critical section for a while. */
+    class slow_reader : public pthread::abstract_thread {
+    public:
+        slow_reader(pthread::rcu_pointer<tracked> &pointer, std::atomic<bool> &reading, int millis) : _pointer(pointer), _reading(reading), _millis(millis), _value(-1) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::rcu_domain> read_side(pthread::rcu_domain::global());
+            tracked *current = _pointer.load();
+            _reading = true;
+            pthread::this_thread::sleep_for(_millis);
+            _value = current->value; // still valid
+        }
+
+        int value() const {
+            return _value;
+        }
+
+    private:
+        pthread::rcu_pointer<tracked> &_pointer;
+        std::atomic<bool> &_reading;
+        int _millis;
+        int _value;
+    };
+}
+
+TEST(rcu, read_side) {
+    pthread::rcu_domain &domain = pthread::rcu_domain::global();
+
+    EXPECT_FALSE(domain.in_read_section());
+    {
+        pthread::lock_guard<pthread::rcu_domain> read_side(domain);
+        EXPECT_TRUE(domain.in_read_section());
+        {
+            pthread::lock_guard<pthread::rcu_domain> nested(domain);
+        }
+        EXPECT_TRUE(domain.in_read_section());
+        EXPECT_THROW(domain.synchronize(), pthread::pthread_exception);
+    }
+    EXPECT_FALSE(domain.in_read_section());
+
+    auto epoch = domain.epoch();
+    domain.synchronize(); // no reader, doesn't wait
+    EXPECT_GT(domain.epoch(), epoch);
+}
+
+TEST(rcu, grace_period) {
+    pthread::rcu_domain &domain = pthread::rcu_domain::global();
+    domain.synchronize();
+    domain.reclaim();
+
+    pthread::rcu_pointer<tracked> pointer{new tracked{1}};
+    std::atomic<bool> reading{false};
+    destroyed = 0;
+
+    slow_reader reader{pointer, reading, 200};
+    reader.start();
+    while (!reading) {
+        pthread::this_thread::sleep_for(1);
+    }
+
+    pointer.update(new tracked{2});
+    EXPECT_EQ(pointer.load()->value, 2);
+    EXPECT_EQ(domain.reclaim(), 0u); // the reader may still use the first version
+    EXPECT_EQ(destroyed, 0);
+    EXPECT_EQ(domain.retired(), 1u);
+
+    auto start = std::chrono::steady_clock::now();
+    domain.synchronize(); // waits for the reader
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    EXPECT_EQ(domain.reclaim(), 1u);
+    EXPECT_EQ(destroyed, 1);
+
+    reader.join();
+    EXPECT_EQ(reader.value(), 1);
+}
+
+TEST(rcu, readers_and_writers) {
+
+    typedef std::map<std::string, int> settings;
+
+    class writer : public pthread::abstract_thread {
+    public:
+        explicit writer(pthread::rcu_pointer<settings> &config) : _config(config) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 1; count <= 2000; count++) {
+                _config.modify([count](settings &copy) {
+                    copy["low"] = count;
+                    copy["high"] = count + 1;
+                });
+            }
+        }
+
+    private:
+        pthread::rcu_pointer<settings> &_config;
+    };
+
+    class reader : public pthread::abstract_thread {
+    public:
+        reader(pthread::rcu_pointer<settings> &config, std::atomic<int> &inconsistent) : _config(config), _inconsistent(inconsistent) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 20000; count++) {
+                pthread::lock_guard<pthread::rcu_domain> read_side(pthread::rcu_domain::global());
+                settings *current = _config.load();
+                if (current->at("high") != current->at("low") + 1) {
+                    _inconsistent++;
+                }
+            }
+        }
+
+    private:
+        pthread::rcu_pointer<settings> &_config;
+        std::atomic<int> &_inconsistent;
+    };
+
+    pthread::rcu_pointer<settings> config{new settings{{"low", 0}, {"high", 1}}};
+    std::atomic<int> inconsistent{0};
+
+    pthread::thread_group threads;
+    threads.add(new writer{config});
+    threads.add(new writer{config});
+    threads.add(new reader{config, inconsistent});
+    threads.add(new reader{config, inconsistent});
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(inconsistent, 0);
+    EXPECT_EQ(config.load()->at("low") + 1, config.load()->at("high"));
+
+    pthread::rcu_domain::global().synchronize();
+    pthread::rcu_domain::global().reclaim();
+    EXPECT_EQ(pthread::rcu_domain::global().retired(), 0u); // retired versions are freed in batches
+}
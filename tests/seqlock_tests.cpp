@@ -0,0 +1,110 @@
+//
+// seqlock_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+
+struct snapshot {
+    long fields[6]; // every field holds the same value, a torn read would mix two values
+};
+
+TEST(seqlock, load_store) {
+    pthread::seqlock<snapshot> lock{snapshot{{1, 1, 1, 1, 1, 1}}};
+
+    EXPECT_EQ(lock.sequence(), 0u);
+    EXPECT_EQ(lock.load().fields[5], 1);
+
+    lock.store(snapshot{{2, 2, 2, 2, 2, 2}});
+    EXPECT_EQ(lock.sequence(), 2u);
+
+    snapshot value;
+    EXPECT_TRUE(lock.try_load(value));
+    EXPECT_EQ(value.fields[0], 2);
+
+    lock.update([](snapshot &current) { current.fields[3] = 3; });
+    EXPECT_EQ(lock.sequence(), 4u);
+    EXPECT_EQ(lock.load().fields[3], 3);
+    EXPECT_EQ(lock.load().fields[4], 2);
+
+    EXPECT_THROW(lock.update([](snapshot &current) {
+        current.fields[0] = 4;
+        throw std::runtime_error("modifier failed");
+    }), std::runtime_error);
+    EXPECT_EQ(lock.sequence() % 2, 0u); // not left locked
+    EXPECT_EQ(lock.load().fields[0], 2);
+
+    pthread::seqlock<char> small{'a'};
+    EXPECT_EQ(small.load(), 'a');
+}
+
+TEST(seqlock, no_torn_reads) {
+
+    class writer : public pthread::abstract_thread {
+    public:
+        explicit writer(pthread::seqlock<snapshot> &lock) : _lock(lock) {
+        }
+
+        void run() noexcept override {
+            for (long count = 1; count <= 100000; count++) {
+                if (count % 2 == 0) {
+                    _lock.store(snapshot{{count, count, count, count, count, count}});
+                } else {
+                    _lock.update([](snapshot &current) {
+                        for (auto &field: current.fields) {
+                            field++;
+                        }
+                    });
+                }
+            }
+        }
+
+    private:
+        pthread::seqlock<snapshot> &_lock;
+    };
+
+    class reader : public pthread::abstract_thread {
+    public:
+        reader(pthread::seqlock<snapshot> &lock, std::atomic<long> &torn) : _lock(lock), _torn(torn) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 100000; count++) {
+                snapshot value = _lock.load();
+                for (auto field: value.fields) {
+                    if (field != value.fields[0]) {
+                        _torn++;
+                        break;
+                    }
+                }
+            }
+        }
+
+    private:
+        pthread::seqlock<snapshot> &_lock;
+        std::atomic<long> &_torn;
+    };
+
+    pthread::seqlock<snapshot> lock{snapshot{{0, 0, 0, 0, 0, 0}}};
+    std::atomic<long> torn{0};
+
+    pthread::thread_group threads;
+    threads.add(new writer{lock});
+    threads.add(new writer{lock});
+    threads.add(new reader{lock, torn});
+    threads.add(new reader{lock, torn});
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(lock.sequence(), 2u * 2 * 100000);
+
+    snapshot last = lock.load();
+    for (auto field: last.fields) {
+        EXPECT_EQ(field, last.fields[0]);
+    }
+}
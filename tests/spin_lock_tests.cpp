@@ -0,0 +1,153 @@
+//
+// spin_lock_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <vector>
+
+template<typename Lock>
+class counting_thread : public pthread::abstract_thread {
+public:
+
+    counting_thread(Lock &lock, long &counter) : _lock(lock), _counter(counter) {
+    }
+
+    void run() noexcept override {
+        for (auto count = 20000; count > 0; count--) {
+            pthread::lock_guard<Lock> guard(_lock);
+            _counter++;
+        }
+    }
+
+private:
+    Lock &_lock;
+    long &_counter;
+};
+
+template<typename Lock>
+long count_concurrently(Lock &lock, int threads_count) {
+    long counter = 0;
+
+    pthread::thread_group threads;
+    for (auto x = threads_count; x > 0; x--) {
+        threads.add(new counting_thread<Lock>{lock, counter});
+    }
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    return counter;
+}
+
+#if defined(_POSIX_SPIN_LOCKS) && _POSIX_SPIN_LOCKS > 0
+TEST(spin_wait, waits_for_the_predicate) {
+    int checks = 0;
+    pthread::util::spin_wait([&checks] { return ++checks == 20; }); // spins, then yields once past max_spins
+    EXPECT_EQ(checks, 20);
+}
+
+TEST(spin_lock, lock_try_lock_unlock) {
+    pthread::spin_lock lock;
+
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+
+    {
+        pthread::lock_guard<pthread::spin_lock> guard(lock);
+        EXPECT_FALSE(lock.try_lock());
+    }
+
+    EXPECT_EQ(count_concurrently(lock, 4), 4 * 20000);
+}
+#endif
+
+TEST(ticket_lock, lock_try_lock_unlock) {
+    pthread::ticket_lock lock;
+
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+
+    {
+        pthread::lock_guard<pthread::ticket_lock> guard(lock);
+        EXPECT_FALSE(lock.try_lock());
+    }
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+
+    EXPECT_EQ(count_concurrently(lock, 4), 4 * 20000);
+}
+
+TEST(ticket_lock, fifo) {
+
+    class ordered_thread : public pthread::abstract_thread {
+    public:
+        ordered_thread(pthread::ticket_lock &lock, std::vector<int> &order, int id) : _lock(lock), _order(order), _id(id) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::ticket_lock> guard(_lock);
+            _order.push_back(_id);
+        }
+
+    private:
+        pthread::ticket_lock &_lock;
+        std::vector<int> &_order;
+        int _id;
+    };
+
+    pthread::ticket_lock lock;
+    std::vector<int> order;
+    pthread::thread_group threads;
+
+    lock.lock();
+    for (auto id = 0; id < 3; id++) {
+        auto thread = new ordered_thread{lock, order, id};
+        threads.add(thread);
+        thread->start();
+        pthread::this_thread::sleep_for(50); // let the thread take its ticket
+    }
+    lock.unlock();
+    threads.join();
+
+    EXPECT_EQ(order, std::vector<int>({0, 1, 2}));
+}
+
+TEST(mcs_lock, lock_try_lock_unlock) {
+    pthread::mcs_lock lock;
+
+    EXPECT_TRUE(lock.try_lock());
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+
+    {
+        pthread::lock_guard<pthread::mcs_lock> guard(lock);
+        EXPECT_FALSE(lock.try_lock());
+    }
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+
+    EXPECT_EQ(count_concurrently(lock, 8), 8 * 20000);
+}
+
+TEST(mcs_lock, many_locks_held) {
+    std::vector<pthread::mcs_lock> locks(10); // more than the per-thread pool of queue nodes
+
+    for (auto &lock: locks) {
+        lock.lock();
+    }
+    for (auto &lock: locks) {
+        EXPECT_FALSE(lock.try_lock());
+    }
+    for (auto &lock: locks) { // not in reverse order
+        lock.unlock();
+    }
+    for (auto &lock: locks) {
+        EXPECT_TRUE(lock.try_lock());
+        lock.unlock();
+    }
+}
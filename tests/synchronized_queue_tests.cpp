@@ -10,6 +10,7 @@
 #include <memory>
 #include <ctime>
 #include <csignal>
+#include <chrono>
 
 #define MESSAGES_TO_PRODUCE 5000 // messages produced
 #define CONSUMER_PROCESSING_DURATION 20 // millis
@@ -216,4 +217,25 @@ TEST(synchronized_queue, producer_consumer) {
     }
 
     EXPECT_EQ(pstatus, EXIT_SUCCESS);
-}
\ No newline at end of file
+}
+
+TEST(synchronized_queue, chrono_timeouts) {
+    pthread::util::sync_queue<int> queue(1);
+    int item = 0;
+
+    auto since = std::chrono::steady_clock::now();
+    EXPECT_THROW(queue.get(item, std::chrono::microseconds(200)), pthread::util::queue_timeout);
+    EXPECT_GE(std::chrono::steady_clock::now() - since, std::chrono::microseconds(200));
+
+    queue.put(1, std::chrono::microseconds(200));
+    EXPECT_THROW(queue.put(2, std::chrono::microseconds(200)), pthread::util::queue_full);
+    EXPECT_THROW(queue.put_until(2, std::chrono::system_clock::now() + std::chrono::milliseconds(1)), pthread::util::queue_full);
+
+    queue.get_until(item, std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+    EXPECT_EQ(item, 1);
+    EXPECT_THROW(queue.get_until(item, std::chrono::steady_clock::now()), pthread::util::queue_timeout);
+
+    queue.put(3, 10); // millis
+    queue.get(item, 10);
+    EXPECT_EQ(item, 3);
+}
@@ -0,0 +1,90 @@
+//
+// thread_specific_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+
+class counting_thread : public pthread::abstract_thread {
+public:
+
+    counting_thread(pthread::thread_specific<std::atomic<long>> &counters, pthread::mutex &mutex, pthread::condition_variable &done, bool &stop) :
+            _counters(counters), _mutex(mutex), _done(done), _stop(stop) {
+    }
+
+    void run() noexcept override {
+        for (auto count = 1000; count > 0; count--) {
+            (*_counters)++;
+        }
+
+        // stay alive until the test has aggregated the counters
+        pthread::lock_guard<pthread::mutex> lck(_mutex);
+        _done.wait(_mutex, [this] { return _stop; });
+    }
+
+private:
+    pthread::thread_specific<std::atomic<long>> &_counters;
+    pthread::mutex &_mutex;
+    pthread::condition_variable &_done;
+    bool &_stop;
+};
+
+TEST(thread_specific, per_thread_instances) {
+    pthread::thread_specific<std::atomic<long>> counters;
+    pthread::mutex mutex;
+    pthread::condition_variable done;
+    bool stop = false;
+
+    pthread::thread_group threads;
+    for (auto x = 4; x > 0; x--) {
+        threads.add(new counting_thread{counters, mutex, done, stop});
+    }
+    threads.start();
+
+    // wait for the 4 threads to have created their counter
+    while (counters.size() < 4) {
+        pthread::this_thread::sleep_for(10);
+    }
+    pthread::this_thread::sleep_for(100);
+
+    long total = 0;
+    counters.for_each([&total](std::atomic<long> &count) {
+        EXPECT_EQ(count, 1000);
+        total += count;
+    });
+    EXPECT_EQ(total, 4000);
+
+    *counters = 10; // main thread has its own instance
+    EXPECT_EQ(*counters, 10);
+    EXPECT_EQ(counters.size(), 5);
+
+    {
+        pthread::lock_guard<pthread::mutex> lck(mutex);
+        stop = true;
+        done.notify_all();
+    }
+    threads.join();
+
+    EXPECT_EQ(counters.size(), 1); // instances are deleted when their thread ends
+    EXPECT_EQ(*counters, 10);
+}
+
+TEST(thread_specific, factory_and_instances_of_same_type) {
+    pthread::thread_specific<std::string> first{[] { return new std::string{"first"}; }};
+    pthread::thread_specific<std::string> second{[] { return new std::string{"second"}; }};
+
+    // alternate accesses, the thread_local cache must not mix instances up
+    for (auto x = 3; x > 0; x--) {
+        EXPECT_EQ(*first, "first");
+        EXPECT_EQ(*second, "second");
+    }
+
+    first->append(" modified");
+    EXPECT_EQ(*first, "first modified");
+    EXPECT_EQ(second->size(), 6);
+}
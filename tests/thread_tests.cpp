@@ -12,6 +12,9 @@
 #include <memory>
 #include <ctime>
 #include <chrono>
+#include <cstring>
+#include <csignal>
+#include <sys/time.h>
 
 class test_runnable : public pthread::runnable {
 public:
@@ -107,6 +110,101 @@ TEST(thread, stack_size) {
     }
 }
 
+class stack_eater : public pthread::runnable {
+public:
+
+    void run() noexcept override {
+        volatile char buffer[64 * 1024];
+        for (std::size_t index = 0; index < sizeof(buffer); index += 512) {
+            buffer[index] = 1;
+        }
+    }
+};
+
+TEST(thread, stack_usage) {
+    display_context_infos();
+
+    size_t stack_size = 524288 * 2;
+    stack_eater eater;
+
+    pthread::thread::measure_stack_usage(true);
+    pthread::thread t{&eater, stack_size};
+    pthread::thread::measure_stack_usage(false);
+
+    t.join();
+    std::cout << "stack usage: " << t.stack_usage() << " bytes" << std::endl;
+    EXPECT_GE(t.stack_usage(), 64 * 1024);
+    EXPECT_LT(t.stack_usage(), stack_size);
+
+    pthread::thread unmeasured{&eater, stack_size};
+    unmeasured.join();
+    EXPECT_EQ(unmeasured.stack_usage(), 0);
+}
+
+class busy_runnable : public pthread::runnable {
+public:
+
+    void run() noexcept override {
+#if defined(__linux__)
+        char buffer[16] = {0};
+        pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+        name = buffer;
+#endif
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+        while (std::chrono::steady_clock::now() < end) {
+            // burning CPU
+        }
+        pthread::this_thread::sleep_for(100);
+    }
+
+    std::string name;
+};
+
+TEST(thread, name_and_accounting) {
+    display_context_infos();
+
+    busy_runnable runner;
+    pthread::thread t{&runner, "busy-worker-with-a-long-name"};
+    EXPECT_EQ(t.name(), "busy-worker-with-a-long-name");
+
+    t.join();
+#if defined(__linux__)
+    EXPECT_EQ(runner.name, "busy-worker-wit"); // truncated to 15 characters
+#endif
+
+    auto accounting = t.accounting();
+    std::cout << accounting.name << ": cpu " << accounting.cpu_time.count() << "ns, wall " << accounting.wall_time.count()
+              << "ns, voluntary switches " << accounting.voluntary_context_switches << ", involuntary switches "
+              << accounting.involuntary_context_switches << std::endl;
+
+    EXPECT_GE(accounting.cpu_time, std::chrono::milliseconds(50));
+    EXPECT_GE(accounting.wall_time, std::chrono::milliseconds(200));
+    EXPECT_LT(accounting.cpu_time, accounting.wall_time);
+#if defined(__linux__)
+    EXPECT_GT(accounting.voluntary_context_switches, 0); // sleep_for gives up the CPU
+#endif
+}
+
+TEST(thread, try_join_and_join_for) {
+    display_context_infos();
+
+    std::unique_ptr<test_runnable> tr{new test_runnable{"timed join test"}}; // runs for about 200ms
+    pthread::thread t{tr.get()};
+
+    EXPECT_FALSE(t.try_join());
+    EXPECT_FALSE(t.join_for(50));
+    EXPECT_TRUE(t.joinable());
+
+    EXPECT_TRUE(t.join_for(2000));
+    EXPECT_FALSE(t.joinable());
+    EXPECT_TRUE(t.try_join()); // nothing left to join
+
+    pthread::thread t2{tr.get()};
+    pthread::this_thread::sleep_for(500);
+    EXPECT_TRUE(t2.try_join());
+    EXPECT_FALSE(t2.joinable());
+}
+
 TEST(thread, status) {
     display_context_infos();
 
@@ -186,6 +284,80 @@ TEST(thread, this_thread_sleep) {
     EXPECT_GT(2.3, duration);
 }
 
+TEST(thread, this_thread_sleep_duration) {
+    auto start = std::chrono::steady_clock::now();
+    pthread::this_thread::sleep_for(std::chrono::microseconds(150));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(150));
+
+    start = std::chrono::steady_clock::now();
+    pthread::this_thread::sleep_for(std::chrono::duration<double, std::milli>(1.5));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(1500));
+
+    EXPECT_NO_THROW(pthread::this_thread::sleep_for(std::chrono::nanoseconds(-1)));
+    EXPECT_THROW(pthread::this_thread::sleep_for(-1), pthread::pthread_exception);
+}
+
+TEST(thread, this_thread_sleep_until) {
+
+    // periodic wake ups don't drift: the time spent between two sleeps doesn't add up
+    auto start = std::chrono::steady_clock::now();
+    auto next = start;
+    for (int period = 0; period < 20; period++) {
+        next += std::chrono::milliseconds(1);
+        pthread::this_thread::sleep_until(next);
+        EXPECT_GE(std::chrono::steady_clock::now(), next);
+        pthread::this_thread::sleep_for(std::chrono::microseconds(200)); // work
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20) + std::chrono::milliseconds(500));
+
+    // hybrid mode
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(2);
+    pthread::this_thread::sleep_until(deadline, std::chrono::microseconds(100));
+    EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+
+    start = std::chrono::steady_clock::now();
+    pthread::this_thread::sleep_for(std::chrono::microseconds(300), std::chrono::microseconds(300));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::microseconds(300));
+
+    // other clocks and deadlines in the past
+    pthread::this_thread::sleep_until(std::chrono::system_clock::now() + std::chrono::microseconds(100));
+    pthread::this_thread::sleep_until(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    pthread::this_thread::sleep_until(std::chrono::steady_clock::time_point());
+
+    pthread::this_thread::yield();
+    pthread::this_thread::pause();
+}
+
+namespace {
+    void ignore_signal(int) {
+    }
+}
+
+TEST(thread, this_thread_sleep_interrupted) {
+    struct sigaction action;
+    struct sigaction previous;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = ignore_signal; // no SA_RESTART, the signal interrupts the sleep
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, &previous);
+
+    itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_usec = 5000; // every 5ms
+    timer.it_interval.tv_usec = 5000;
+    setitimer(ITIMER_REAL, &timer, nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pthread::this_thread::sleep_for(50);
+    auto slept = std::chrono::steady_clock::now() - start;
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_REAL, &timer, nullptr);
+    sigaction(SIGALRM, &previous, nullptr);
+
+    EXPECT_GE(slept, std::chrono::milliseconds(50));
+}
+
 TEST(thread, this_thread_get_id) {
     auto id = pthread::this_thread::get_id();
 }
\ No newline at end of file
@@ -0,0 +1,162 @@
+//
+// unique_lock_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <utility>
+
+pthread::unique_lock<pthread::mutex> locked(pthread::mutex &mutex) {
+    return pthread::unique_lock<pthread::mutex>{mutex};
+}
+
+TEST(unique_lock, ownership) {
+    pthread::mutex mutex;
+
+    {
+        pthread::unique_lock<pthread::mutex> lock{mutex};
+        EXPECT_TRUE(lock.owns_lock());
+        EXPECT_EQ(lock.mutex(), &mutex);
+        EXPECT_FALSE(mutex.try_lock());
+
+        lock.unlock();
+        EXPECT_FALSE(lock);
+        EXPECT_THROW(lock.unlock(), pthread::mutex_exception);
+
+        lock.lock();
+        EXPECT_TRUE(lock);
+        EXPECT_THROW(lock.lock(), pthread::mutex_exception);
+    }
+    EXPECT_TRUE(mutex.try_lock()); // unlocked by the unique_lock destructor
+
+    {
+        pthread::unique_lock<pthread::mutex> lock{mutex, pthread::try_to_lock};
+        EXPECT_FALSE(lock.owns_lock());
+    }
+
+    {
+        pthread::unique_lock<pthread::mutex> lock{mutex, pthread::adopt_lock};
+        EXPECT_TRUE(lock.owns_lock());
+    }
+
+    {
+        pthread::unique_lock<pthread::mutex> lock{mutex, pthread::defer_lock};
+        EXPECT_FALSE(lock.owns_lock());
+        EXPECT_TRUE(lock.try_lock());
+
+        pthread::mutex *released = lock.release();
+        EXPECT_EQ(released, &mutex);
+        EXPECT_EQ(lock.mutex(), nullptr);
+        EXPECT_THROW(lock.lock(), pthread::mutex_exception);
+        released->unlock();
+    }
+
+    pthread::unique_lock<pthread::mutex> empty;
+    EXPECT_FALSE(empty.owns_lock());
+    EXPECT_EQ(empty.mutex(), nullptr);
+}
+
+TEST(unique_lock, move) {
+    pthread::mutex mutex;
+    pthread::mutex other;
+
+    pthread::unique_lock<pthread::mutex> lock = locked(mutex);
+    EXPECT_TRUE(lock.owns_lock());
+
+    pthread::unique_lock<pthread::mutex> moved{std::move(lock)};
+    EXPECT_FALSE(lock.owns_lock());
+    EXPECT_EQ(lock.mutex(), nullptr);
+    EXPECT_TRUE(moved.owns_lock());
+
+    pthread::unique_lock<pthread::mutex> assigned{other};
+    assigned = std::move(moved); // other is unlocked
+    EXPECT_TRUE(other.try_lock());
+    other.unlock();
+    EXPECT_EQ(assigned.mutex(), &mutex);
+
+    pthread::unique_lock<pthread::mutex> swapped;
+    swapped.swap(assigned);
+    EXPECT_TRUE(swapped.owns_lock());
+    EXPECT_FALSE(assigned.owns_lock());
+}
+
+TEST(unique_lock, condition_variable) {
+    pthread::mutex mutex;
+    pthread::condition_variable condition;
+
+    pthread::unique_lock<pthread::mutex> lock{mutex};
+    EXPECT_EQ(condition.wait_for(lock, 10), pthread::timedout);
+    EXPECT_FALSE(condition.wait_for(lock, 10, [] { return false; }));
+    EXPECT_TRUE(condition.wait(lock, [] { return true; }));
+    EXPECT_TRUE(lock.owns_lock());
+    EXPECT_FALSE(mutex.try_lock());
+}
+
+TEST(unique_lock, try_lock) {
+    pthread::mutex first;
+    pthread::mutex second;
+    pthread::mutex third;
+
+    EXPECT_EQ(pthread::try_lock(first, second, third), -1);
+    first.unlock();
+    second.unlock();
+    third.unlock();
+
+    second.lock();
+    EXPECT_EQ(pthread::try_lock(first, second, third), 1);
+    EXPECT_TRUE(first.try_lock()); // released by try_lock
+    first.unlock();
+    second.unlock();
+}
+
+TEST(unique_lock, lock_without_deadlock) {
+
+    struct account {
+        pthread::mutex mutex;
+        long balance = 1000000;
+    };
+
+    class transferring_thread : public pthread::abstract_thread {
+    public:
+        transferring_thread(account &from, account &to) : _from(from), _to(to) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 20000; count++) {
+                pthread::unique_lock<pthread::mutex> from_lock{_from.mutex, pthread::defer_lock};
+                pthread::unique_lock<pthread::mutex> to_lock{_to.mutex, pthread::defer_lock};
+                pthread::lock(from_lock, to_lock);
+
+                _from.balance -= 1;
+                _to.balance += 1;
+            }
+        }
+
+    private:
+        account &_from;
+        account &_to;
+    };
+
+    account first;
+    account second;
+    account third;
+
+    pthread::thread_group threads;
+    threads.add(new transferring_thread{first, second}); // opposite orders
+    threads.add(new transferring_thread{second, first});
+    threads.add(new transferring_thread{second, third});
+    threads.add(new transferring_thread{third, first});
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(first.balance + second.balance + third.balance, 3000000);
+    EXPECT_EQ(first.balance, 1020000); // first -> second and second -> first cancel each other out
+
+    pthread::lock(first.mutex, second.mutex, third.mutex);
+    pthread::lock_guard<pthread::mutex> first_guard{first.mutex, pthread::adopt_lock};
+    pthread::lock_guard<pthread::mutex> second_guard{second.mutex, pthread::adopt_lock};
+    pthread::lock_guard<pthread::mutex> third_guard{third.mutex, pthread::adopt_lock};
+    EXPECT_FALSE(second.mutex.try_lock());
+}
@@ -0,0 +1,140 @@
+//
+// upgradable_lock_tests.cpp
+//
+
+#include <pthread.h>
+#include "pthread/pthread.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <map>
+
+TEST(upgradable_lock, lock_try_lock_unlock) {
+    pthread::upgradable_read_write_lock rwlock;
+    pthread::upgradable_read_lock &reader = rwlock;
+    pthread::upgrade_lock &upgrader = rwlock;
+
+    EXPECT_TRUE(upgrader.try_lock());
+    EXPECT_TRUE(reader.try_lock());    // readers share the lock with the upgrader
+    EXPECT_FALSE(upgrader.try_lock()); // one upgrader at a time
+    EXPECT_FALSE(rwlock.try_lock());
+    reader.unlock();
+
+    upgrader.promote();
+    EXPECT_THROW(upgrader.promote(), pthread::read_write_lock_exception);
+    EXPECT_FALSE(reader.try_lock());
+    upgrader.demote();
+    EXPECT_THROW(upgrader.demote(), pthread::read_write_lock_exception);
+    EXPECT_TRUE(reader.try_lock());
+    reader.unlock();
+    upgrader.unlock();
+
+    EXPECT_THROW(upgrader.promote(), pthread::read_write_lock_exception);
+
+    {
+        pthread::lock_guard<pthread::upgrade_lock> lock(rwlock);
+        rwlock.promote(); // the lock_guard releases the write lock
+    }
+
+    EXPECT_TRUE(rwlock.try_lock());
+    EXPECT_FALSE(reader.try_lock());
+    EXPECT_FALSE(upgrader.try_lock());
+    rwlock.unlock();
+}
+
+TEST(upgradable_lock, promote_waits_for_readers) {
+
+    class upgrader : public pthread::abstract_thread {
+    public:
+        upgrader(pthread::upgradable_read_write_lock &rwlock, std::atomic<bool> &promoted) : _rwlock(rwlock), _promoted(promoted) {
+        }
+
+        void run() noexcept override {
+            pthread::lock_guard<pthread::upgrade_lock> lock(_rwlock);
+            _rwlock.promote();
+            _promoted = true;
+        }
+
+    private:
+        pthread::upgradable_read_write_lock &_rwlock;
+        std::atomic<bool> &_promoted;
+    };
+
+    pthread::upgradable_read_write_lock rwlock;
+    pthread::upgradable_read_lock &reader = rwlock;
+    std::atomic<bool> promoted{false};
+
+    reader.lock();
+    upgrader thread{rwlock, promoted};
+    thread.start();
+    pthread::this_thread::sleep_for(50); // let the upgrader wait for the reader
+
+    EXPECT_FALSE(promoted);
+    EXPECT_FALSE(reader.try_lock()); // the promotion stops new readers
+    reader.unlock();
+    thread.join();
+
+    EXPECT_TRUE(promoted);
+    EXPECT_TRUE(reader.try_lock());
+    reader.unlock();
+}
+
+TEST(upgradable_lock, cache_fill) {
+
+    struct cache {
+        pthread::upgradable_read_write_lock rwlock;
+        std::map<int, int> entries;
+        std::atomic<int> fills{0};
+    };
+
+    class filler : public pthread::abstract_thread {
+    public:
+        explicit filler(cache &shared) : _shared(shared) {
+        }
+
+        void run() noexcept override {
+            for (auto key = 0; key < 100; key++) {
+                pthread::lock_guard<pthread::upgrade_lock> lock(_shared.rwlock);
+                if (_shared.entries.find(key) == _shared.entries.end()) {
+                    _shared.rwlock.promote(); // no need to look the key up again
+                    _shared.entries[key] = key * 2;
+                    _shared.fills++;
+                }
+            }
+        }
+
+    private:
+        cache &_shared;
+    };
+
+    class reader : public pthread::abstract_thread {
+    public:
+        explicit reader(cache &shared) : _shared(shared) {
+        }
+
+        void run() noexcept override {
+            for (auto count = 0; count < 1000; count++) {
+                pthread::lock_guard<pthread::upgradable_read_lock> lock(_shared.rwlock);
+                auto entry = _shared.entries.find(count % 100);
+                if (entry != _shared.entries.end()) {
+                    EXPECT_EQ(entry->second, entry->first * 2);
+                }
+            }
+        }
+
+    private:
+        cache &_shared;
+    };
+
+    cache shared;
+    pthread::thread_group threads;
+    for (auto x = 0; x < 3; x++) {
+        threads.add(new filler{shared});
+        threads.add(new reader{shared});
+    }
+    threads.start(pthread::start_mode::barrier);
+    threads.join();
+
+    EXPECT_EQ(shared.fills, 100); // each key was filled once
+    EXPECT_EQ(shared.entries.size(), 100u);
+}